@@ -0,0 +1,247 @@
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Throughput and latency of the ways the renderer can get bytes into a GPU buffer, for payloads
+/// of 64 B to 64 MiB. Runs on Dawn's fallback (SwiftShader) adapter unless `--hardware` is
+/// given, so results compare across machines, and writes them as JSON to `--out`.
+namespace dvdbchar::bench {
+	using namespace Render;
+
+	using Clock	 = std::chrono::steady_clock;
+	using Upload = std::function<void(std::span<const std::byte>)>;
+
+	inline constexpr uint64_t min_size		 = 64;
+	inline constexpr uint64_t max_size		 = 64 << 20;
+	inline constexpr uint64_t bytes_per_run	 = 256 << 20;  // iterations shrink as payloads grow
+	inline constexpr uint64_t min_iterations = 4;
+	inline constexpr uint64_t max_iterations = 256;
+
+	/// One upload strategy. `prepare()` allocates whatever outlives a single upload of `size`
+	/// bytes and returns the upload itself, which submits its own work.
+	struct UploadPath {
+		std::string_view					 name;
+		std::function<Upload(uint64_t size)> prepare;
+	};
+
+	inline auto to_string(wgpu::StringView view) -> std::string {
+		return std::string { std::string_view(view) };
+	}
+
+	/// Blocks until the GPU finished everything submitted, then runs the pending callbacks.
+	inline void wait_idle(const WgpuContext& ctx) {
+		ctx.instance.WaitAny(
+			ctx.queue.OnSubmittedWorkDone(
+				wgpu::CallbackMode::WaitAnyOnly,
+				[](wgpu::QueueWorkDoneStatus, wgpu::StringView) {}
+			),
+			std::numeric_limits<uint64_t>::max()
+		);
+		ctx.instance.ProcessEvents();
+	}
+
+	inline auto destination(const WgpuContext& ctx, uint64_t size, bool mapped = false)
+		-> wgpu::Buffer {
+		const wgpu::BufferDescriptor desc {
+			.usage			  = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+			.size			  = size,
+			.mappedAtCreation = mapped,
+		};
+		return ctx.device.CreateBuffer(&desc);
+	}
+
+	inline auto upload_paths(const WgpuContext& ctx) -> std::vector<UploadPath> {
+		return {
+			{
+				.name	 = "write_buffer",
+				.prepare = [&ctx](uint64_t size) -> Upload {
+					return [&ctx, dst = destination(ctx, size)](auto data) {
+						ctx.queue.WriteBuffer(dst, 0, data.data(), data.size());
+					};
+				},
+			},
+			{
+				// `array_buffer()` and friends: a fresh buffer filled before its first use.
+				.name	 = "mapped_at_creation",
+				.prepare = [&ctx](uint64_t) -> Upload {
+					return [&ctx](auto data) {
+						auto dst = destination(ctx, data.size(), true);
+						std::memcpy(dst.GetMappedRange(0, data.size()), data.data(), data.size());
+						dst.Unmap();
+					};
+				},
+			},
+			{
+				// `UploadContext` over its `StagingBelt`, which also carries `bufcpy()` and
+				// `StagedBuffer` writes.
+				.name	 = "staging_belt",
+				.prepare = [&ctx](uint64_t size) -> Upload {
+					auto uploads = std::make_shared<UploadContext>(ctx);
+					return [uploads, dst = destination(ctx, size)](auto data) {
+						uploads->write(dst, 0, data);
+						uploads->submit();
+					};
+				},
+			},
+			{
+				// One persistent `MapWrite` buffer, remapped per upload: waits for the last copy.
+				.name	 = "map_async",
+				.prepare = [&ctx](uint64_t size) -> Upload {
+					const wgpu::BufferDescriptor desc {
+						.usage = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc,
+						.size  = size,
+					};
+					auto staging = ctx.device.CreateBuffer(&desc);
+					return [&ctx, staging, dst = destination(ctx, size)](auto data) {
+						ctx.instance.WaitAny(
+							staging.MapAsync(
+								wgpu::MapMode::Write,
+								0,
+								data.size(),
+								wgpu::CallbackMode::WaitAnyOnly,
+								[](wgpu::MapAsyncStatus, wgpu::StringView) {}
+							),
+							std::numeric_limits<uint64_t>::max()
+						);
+						std::memcpy(
+							staging.GetMappedRange(0, data.size()),
+							data.data(),
+							data.size()
+						);
+						staging.Unmap();
+
+						const auto cmd = ctx.device.CreateCommandEncoder();
+						cmd.CopyBufferToBuffer(staging, 0, dst, 0, data.size());
+						const auto commands = cmd.Finish();
+						ctx.queue.Submit(1, &commands);
+					};
+				},
+			},
+		};
+	}
+
+	/// Latency is one upload until the GPU is idle again; throughput streams uploads back to
+	/// back and waits once at the end.
+	inline auto measure(const WgpuContext& ctx, const UploadPath& path, uint64_t size)
+		-> nlohmann::json {
+		const auto iterations = std::clamp(bytes_per_run / size, min_iterations, max_iterations);
+		std::vector<std::byte> payload(size);
+		for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<std::byte>(i * 31);
+
+		const auto upload = path.prepare(size);
+		upload(payload);  // warm-up, pays the first-use allocations
+		wait_idle(ctx);
+
+		std::vector<double> latencies;
+		for (uint64_t i = 0; i < iterations; ++i) {
+			const auto start = Clock::now();
+			upload(payload);
+			wait_idle(ctx);
+			const std::chrono::duration<double, std::micro> latency = Clock::now() - start;
+			latencies.push_back(latency.count());
+		}
+		std::ranges::sort(latencies);
+		const auto percentile = [&](double p) {
+			return latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))];
+		};
+
+		const auto start = Clock::now();
+		for (uint64_t i = 0; i < iterations; ++i) {
+			upload(payload);
+			ctx.instance.ProcessEvents();
+		}
+		wait_idle(ctx);
+		const std::chrono::duration<double> elapsed = Clock::now() - start;
+		const auto throughput = static_cast<double>(size * iterations) / elapsed.count();
+
+		spdlog::info(
+			"{:<20} {:>10} B  median {:>10.1f} us  {:>10.1f} MiB/s",
+			path.name,
+			size,
+			percentile(.5),
+			throughput / (1 << 20)
+		);
+		return {
+			{ "path", path.name },
+			{ "bytes", size },
+			{ "iterations", iterations },
+			{ "latency_us",
+			  {
+				  { "min", latencies.front() },
+				  { "median", percentile(.5) },
+				  { "p95", percentile(.95) },
+				  { "max", latencies.back() },
+			  } },
+			{ "throughput_bytes_per_s", throughput },
+		};
+	}
+
+	inline auto adapter_info(const WgpuContext& ctx, bool fallback) -> nlohmann::json {
+		wgpu::AdapterInfo info;
+		ctx.adapter.GetInfo(&info);
+		return {
+			{ "vendor", to_string(info.vendor) },
+			{ "architecture", to_string(info.architecture) },
+			{ "device", to_string(info.device) },
+			{ "description", to_string(info.description) },
+			{ "backend", static_cast<uint32_t>(info.backendType) },
+			{ "fallback", fallback },
+		};
+	}
+}  // namespace dvdbchar::bench
+
+int main(int argc, char** argv) {
+	using namespace dvdbchar::bench;
+
+	bool		hardware = false;
+	std::string out		 = "upload_bench.json";
+	for (int i = 1; i < argc; ++i) {
+		const auto arg = std::string_view { argv[i] };
+		if (arg == "--hardware")
+			hardware = true;
+		else if (arg == "--out" && i + 1 < argc)
+			out = argv[++i];
+		else {
+			spdlog::error("usage: {} [--hardware] [--out <results.json>]", argv[0]);
+			return 1;
+		}
+	}
+
+	WgpuContext::Spec spec;
+	spec.adapter_opts.forceFallbackAdapter = !hardware;
+	const auto ctx						   = WgpuContext::create(spec);
+
+	auto results = nlohmann::json {
+		{ "adapter", adapter_info(ctx, !hardware) },
+		{ "results", nlohmann::json::array() },
+	};
+	spdlog::info("benchmarking uploads on `{}`", results["adapter"]["device"].get<std::string>());
+	for (const auto& path : upload_paths(ctx))
+		for (uint64_t size = min_size; size <= max_size; size *= 4)
+			results["results"].push_back(measure(ctx, path, size));
+
+	std::ofstream file { out };
+	file << results.dump(2) << '\n';
+	if (!file) {
+		spdlog::error("failed to write results to `{}`", out);
+		return 1;
+	}
+	spdlog::info("results written to `{}`", out);
+	return 0;
+}
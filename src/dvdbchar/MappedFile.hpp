@@ -0,0 +1,119 @@
+#pragma once
+
+#ifdef _WIN32
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace dvdbchar {
+	/// Read-only memory mapping of a whole file.
+	class MappedFile {
+	public:
+		MappedFile(const MappedFile&)			 = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& another) noexcept :
+			_data(std::exchange(another._data, nullptr)), _size(std::exchange(another._size, 0)) {}
+
+		MappedFile& operator=(MappedFile&& another) noexcept {
+			if (this != std::addressof(another)) {
+				_unmap();
+				_data = std::exchange(another._data, nullptr);
+				_size = std::exchange(another._size, 0);
+			}
+			return *this;
+		}
+
+		~MappedFile() { _unmap(); }
+
+	public:
+		inline static auto open(const std::filesystem::path& path) -> std::optional<MappedFile> {
+#ifdef _WIN32
+			const HANDLE file = CreateFileW(
+				path.c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+				nullptr
+			);
+			if (file == INVALID_HANDLE_VALUE)
+				return std::nullopt;
+
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+				CloseHandle(file);
+				return std::nullopt;
+			}
+
+			const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			CloseHandle(file);
+			if (!mapping)
+				return std::nullopt;
+
+			void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+			if (!data)
+				return std::nullopt;
+
+			return MappedFile { static_cast<std::byte*>(data), static_cast<size_t>(size.QuadPart) };
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				return std::nullopt;
+
+			struct stat st;
+			if (fstat(fd, &st) != 0 || st.st_size == 0) {
+				::close(fd);
+				return std::nullopt;
+			}
+
+			void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+			if (data == MAP_FAILED)
+				return std::nullopt;
+
+			return MappedFile { static_cast<std::byte*>(data), static_cast<size_t>(st.st_size) };
+#endif
+		}
+
+	public:
+		[[nodiscard]] auto bytes() const -> std::span<const std::byte> { return { _data, _size }; }
+
+		[[nodiscard]] auto data() const -> const std::byte* { return _data; }
+
+		[[nodiscard]] auto size() const -> size_t { return _size; }
+
+	private:
+		MappedFile(std::byte* data, size_t size) : _data(data), _size(size) {}
+
+		void _unmap() {
+			if (!_data)
+				return;
+#ifdef _WIN32
+			UnmapViewOfFile(_data);
+#else
+			munmap(_data, _size);
+#endif
+			_data = nullptr;
+		}
+
+	private:
+		std::byte* _data = nullptr;
+		size_t	   _size = 0;
+	};
+}  // namespace dvdbchar
@@ -1,22 +1,34 @@
 #pragma once
 
 #include "Render/Buffer.hpp"
+#include "dvdbchar/Render/Instancing.hpp"
+#include "dvdbchar/Render/Material.hpp"
 #include "dvdbchar/Render/Mesh.hpp"
 #include "dvdbchar/Render/Pipeline.hpp"
 #include "dvdbchar/Render/Primitives.hpp"
 #include "dvdbchar/Render/ShaderReflection.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
 #include "dvdbchar/Render/Texture.hpp"
-#include "dvdbchar/Stb.hpp"
-#include "fastgltf/types.hpp"
+#include "dvdbchar/MappedFile.hpp"
+#include "dvdbchar/Model/BakedModel.hpp"
+#include "dvdbchar/Model/ModelBaker.hpp"
+#include "dvdbchar/Model/NodeConstraint.hpp"
+#include "dvdbchar/Model/SceneGraph.hpp"
+#include "dvdbchar/Model/SpringBone.hpp"
 
 #include <glm/glm.hpp>
-#include <fastgltf/core.hpp>
-#include <fastgltf/util.hpp>
-#include <fastgltf/tools.hpp>
 #include <spdlog/spdlog.h>
+#include <stdexec/execution.hpp>
 
+#include <chrono>
+#include <cstring>
+#include <deque>
 #include <filesystem>
+#include <limits>
+#include <set>
+#include <span>
 #include <stdexcept>
+#include <string>
 
 namespace dvdbchar {
 	template<typename T>
@@ -24,305 +36,711 @@ namespace dvdbchar {
 
 	class Model {
 	public:
-		Model(const std::filesystem::path& path) {
-			using namespace fastgltf;
-			constexpr auto parser_opt = fastgltf::Extensions::KHR_mesh_quantization
-									  | fastgltf::Extensions::KHR_texture_transform
-									  | fastgltf::Extensions::KHR_materials_variants;
-			constexpr auto asset_opt = fastgltf::Options::LoadExternalBuffers	//
-									 | fastgltf::Options::LoadExternalImages	//
-									 | fastgltf::Options::AllowDouble			//
-									 | fastgltf::Options::GenerateMeshIndices;	//
-
-			auto parser = Parser { parser_opt };
-			auto file	= fastgltf::MappedGltfFile::FromPath(path);
-			if (!file)
+		/// Loads `path` through its baked pack and uploads it completely before returning.
+		Model(const Render::WgpuContext& ctx, const std::filesystem::path& path) :
+			Model(ctx, load_pack(path), path.filename().string()) {
+			const auto			  start = std::chrono::steady_clock::now();
+			Render::UploadContext uploads { ctx };
+			while (!upload_some(uploads)) {}
+			uploads.submit();
+
+			const std::chrono::duration<double, std::milli> elapsed =
+				std::chrono::steady_clock::now() - start;
+			spdlog::info("uploaded model `{}` in {:.2f} ms", path.string(), elapsed.count());
+		}
+
+		Model(const std::filesystem::path& path) : Model(Render::WgpuContext::global(), path) {}
+
+		/// Takes over `baked` without touching the GPU; `upload_some()` streams it in. GPU memory
+		/// is accounted to `name`.
+		Model(const Render::WgpuContext& ctx, BakedModel&& baked, std::string name = "model") :
+			_ctx(&ctx), _name(std::move(name)), _baked(std::move(baked)), _scene(_baked.nodes()),
+			_constraints(_baked), _springs(_baked, _scene), _instances(ctx),
+			_morph_weights(
+				_baked.morph_targets()
+				| ranges::views::transform(&baked::MorphTarget::default_weight)
+				| ranges::to<std::vector>()
+			) {}
+
+		Model(Model&&) noexcept			   = default;
+		Model& operator=(Model&&) noexcept = default;
+
+	public:
+		/// Maps the baked pack of `path` (`<path>.baked`). The pack is (re)baked from the glTF
+		/// source whenever it is missing, outdated, corrupted or the source's size or
+		/// modification time changed. CPU only, so it may run on any thread.
+		[[nodiscard]] inline static auto load_pack(const std::filesystem::path& path)
+			-> BakedModel {
+			const auto start = std::chrono::steady_clock::now();
+
+			const auto source = baked::source_of(path);
+			if (!source)
 				throw std::runtime_error {
 					std::format("Failed to read model file at `{}`.", path.string())
 				};
 
-			auto asset = parser.loadGltf(file.get(), path.parent_path(), asset_opt);
-			if (asset)
-				_asset = std::move(asset.get());
-			else {
-				throw std::runtime_error { std::format(
-					"Failed to load model at `{}`: {}",
-					path.string(),
-					(int)asset.error()
-				) };
+			const auto pack_path = BakedModel::pack_path_of(path);
+			auto	   baked	 = BakedModel::load(pack_path, *source);
+			if (!baked) {
+				baked = bake_model(load_gltf(path), load_gltf_json(path), *source);
+				if (!baked->save(pack_path))
+					spdlog::warn("failed to write baked model to `{}`.", pack_path.string());
 			}
+
+			const std::chrono::duration<double, std::milli> elapsed =
+				std::chrono::steady_clock::now() - start;
+			spdlog::info("loaded model `{}` in {:.2f} ms", path.string(), elapsed.count());
+			return std::move(*baked);
+		}
+
+		/// Sender loading the pack of `path` on `sch`, completing with a `Model` that has not
+		/// been uploaded yet. Drive `upload_some()` from the render thread to stream it in.
+		template<stdexec::scheduler Sch>
+		[[nodiscard]] inline static auto load_async(
+			const Render::WgpuContext& ctx, const std::filesystem::path& path, Sch&& sch
+		) {
+			return stdexec::schedule(std::forward<Sch>(sch))  //
+				 | stdexec::then([&ctx, path]() {
+					   return Model { ctx, load_pack(path), path.filename().string() };
+				   });
+		}
+
+		template<stdexec::scheduler Sch>
+		[[nodiscard]] inline static auto load_async(const std::filesystem::path& path, Sch&& sch) {
+			return load_async(Render::WgpuContext::global(), path, std::forward<Sch>(sch));
 		}
 
 	public:
-		[[nodiscard]] auto&		  asset() { return _asset; }
+		/// Uploads pending data into `uploads`, stopping once roughly `budget` bytes went out.
+		/// Geometry streams first in chunks, then the skinning and morph data, then textures; a
+		/// primitive becomes visible in `primitives()` once all of the geometry and its material's
+		/// texture are resident. Returns whether everything is uploaded.
+		auto upload_some(
+			Render::UploadContext& uploads, size_t budget = std::numeric_limits<size_t>::max()
+		) -> bool {
+			const Render::MemoryTracker::Scope scope { _name };
+			if (!_buf_vertex) {
+				_upload_geometry();
+				_prepare_materials();
+			}
+
+			auto spent = _stage_pending(uploads, budget);
+			if (_pending.empty() && !_buf_world) {
+				_upload_scene();
+				if (!_baked.skinned_ranges().empty())
+					spent += _upload_skinning(uploads);
+				spent += _stage_pending(uploads, budget - std::min(spent, budget));
+			}
+			_resident = _pending.empty() && _buf_world;
+
+			const auto images = _baked.images();
+			while (_resident && _textures.size() < images.size() && spent < budget) {
+				const auto& image  = images[_textures.size()];
+				const auto	levels = ranges::views::iota(0u, image.mip_count)
+								   | ranges::views::transform([&](uint32_t level) {
+										 return _baked.mip(image, level);
+									 })
+								   | ranges::to<std::vector>();
+				_textures.emplace_back(Render::texture_from_mips(*_ctx, levels));
+				spent += image.pixel_size;
+			}
+
+			_publish();
+			return loaded();
+		}
+
+		[[nodiscard]] auto name() const -> const std::string& { return _name; }
+
+		[[nodiscard]] auto loaded() const -> bool {
+			return static_cast<size_t>(std::ranges::count(_published, true))
+				== _baked.primitives().size();
+		}
+
+		[[nodiscard]] auto primitives() const -> std::span<const Render::MeshPrimitive> {
+			return _primitives;
+		}
+
+		[[nodiscard]] auto materials() const -> std::span<const Render::PbrMaterial> {
+			return _materials;
+		}
+
+		/// Vertex ranges `Pass::SkinningPass` has to process before drawing `primitives()`.
+		[[nodiscard]] auto skinned_meshes() const -> std::span<const Render::SkinnedMesh> {
+			return _skinned_meshes;
+		}
+
+		/// Morph targets with a non-zero weight, as of the last `update()`.
+		[[nodiscard]] auto active_morph_targets() const -> std::span<const Render::MorphTarget> {
+			return _active_morphs;
+		}
+
+		/// Node world matrices that `MeshPrimitive::instance` indexes into, plus `instances()`.
+		[[nodiscard]] auto scene_bindgroup() const -> const wgpu::BindGroup& { return _bg_scene; }
+
+		/// Copies of the model to draw, one untransformed copy unless assigned otherwise. Draw
+		/// `primitives()[i]` as draw `i` of them.
+		[[nodiscard]] auto instances() const -> const Render::InstanceSet& { return _instances; }
+
+		[[nodiscard]] auto instances() -> Render::InstanceSet& { return _instances; }
+
+		/// Per-vertex offsets the morph targets accumulate into; `Pass::SkinningPass` clears it.
+		[[nodiscard]] auto morph_offsets() const -> const wgpu::Buffer& {
+			return _buf_morph_offsets;
+		}
+
+		/// Index of morph target `index` of glTF mesh `mesh`, as taken by `set_morph_weight`.
+		[[nodiscard]] auto morph_target(uint32_t mesh, uint32_t index) const -> uint32_t {
+			const auto& morph_mesh = _baked.meshes()[mesh];
+			if (index >= morph_mesh.target_count) [[unlikely]]
+				throw std::out_of_range { std::format(
+					"mesh {} has {} morph targets, {} requested",
+					mesh,
+					morph_mesh.target_count,
+					index
+				) };
+			return morph_mesh.first_target + index;
+		}
+
+		/// Weights set before the morph targets are uploaded are kept and uploaded with them.
+		void set_morph_weight(uint32_t target, float weight) {
+			if (target >= _morph_weights.size()) [[unlikely]]
+				throw std::out_of_range { std::format(
+					"model has {} morph targets, {} requested",
+					_morph_weights.size(),
+					target
+				) };
+			if (std::exchange(_morph_weights[target], weight) != weight)
+				_morph_dirty = true;
+		}
 
-		[[nodiscard]] const auto& asset() const { return _asset; }
+		/// Evaluates node constraints, steps the spring bones, uploads the world matrices of the
+		/// nodes that moved, the joint palette of every skin, and the morph weights when they
+		/// changed, all recorded into the frame's `uploads`. Also refreshes the draw arguments of
+		/// `instances()` once primitives were published.
+		void update(Render::UploadContext& uploads) {
+			if (!_resident)
+				return;
+			const Render::MemoryTracker::Scope scope { _name };
+
+			_relocate();
+			if (_instances.empty())
+				_instances.assign(uploads, std::array { Render::Instance {} });
+			if (std::exchange(_draws_dirty, false))
+				_instances.set_draws(uploads, _primitives);
+			if (const auto generation = _instances.generation();
+				std::exchange(_scene_generation, generation) != generation)
+				_bind_scene();
+
+			const auto now = std::chrono::steady_clock::now();
+			const std::chrono::duration<float> dt = now - std::exchange(_last_update, now);
+			_constraints.update(_scene);
+			if (!_springs.empty()) {
+				_scene.update();
+				_springs.update(dt.count(), _scene);
+			}
+			_scene.update();
+			if (const auto [first, last] = _scene.take_changed(); first != last)
+				uploads.write(
+					_buf_world,
+					first * sizeof(glm::mat4),
+					std::as_bytes(_scene.world().subspan(first, last - first))
+				);
+
+			if (_buf_morph_weights && std::exchange(_morph_dirty, false)) {
+				uploads.write(_buf_morph_weights, 0, std::as_bytes(std::span { _morph_weights }));
+				_active_morphs.clear();
+				for (const auto& [i, target] : ranges::views::enumerate(_morph_targets))
+					if (_morph_weights[i] != 0.f && target.delta_count > 0)
+						_active_morphs.push_back(target);
+			}
+
+			if (!_buf_palette)
+				return;
+			_update_palette();
+			uploads.write(_buf_palette, 0, std::as_bytes(std::span { _palette }));
+		}
 
 	public:
 		void introduce_self() const {
-			spdlog::info("textures:");
-			for (const auto& tex : _asset.textures) spdlog::info("{}", tex.name);
-			spdlog::info("version: {}", _asset.assetInfo->gltfVersion);
-			spdlog::info("mesh[{}]", _asset.meshes.size());
-			spdlog::info("accessor[{}]", _asset.accessors.size());
-			// for (const auto& acc : _asset.accessors) spdlog::info("acc: {}", acc.name);
-			for (const auto& m : _asset.meshes) {
-				for (const auto& p : m.primitives) {
-					auto& acc = _asset.accessors[p.findAttribute("POSITION")->accessorIndex];
-					fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
-						_asset,
-						acc,
-						[](const fastgltf::math::fvec3& vec, size_t i) {
-							// spdlog::info("{}, {}, {}", vec.x(), vec.y(), vec.z());
-						}
+			spdlog::info("textures[{}]", _textures.size());
+			spdlog::info("materials[{}]", _materials.size());
+			spdlog::info("primitives[{}]", _primitives.size());
+			spdlog::info("skinned meshes[{}]", _skinned_meshes.size());
+			spdlog::info(
+				"geometry: {} bytes of vertices, {} bytes of indices",
+				_buf_vertex ? _buf_vertex.size() : 0,
+				_buf_index ? _buf_index.size() : 0
+			);
+		}
+
+	private:
+		/// Where `_buf_vertex` and `_buf_index` were when the draws over them were built.
+		struct Placement {
+			wgpu::Buffer vertex;
+			uint64_t	 vertex_offset = 0;
+			wgpu::Buffer index;
+			uint64_t	 index_offset = 0;
+
+			[[nodiscard]] auto operator==(const Placement& another) const -> bool {
+				return vertex.Get() == another.vertex.Get()
+					&& vertex_offset == another.vertex_offset && index.Get() == another.index.Get()
+					&& index_offset == another.index_offset;
+			}
+		};
+
+		/// Pack bytes still to be staged, into a geometry range or else into `buffer`. Ranges are
+		/// named by member so the write follows both a move of the model and a `compact()`.
+		struct PendingWrite {
+			Render::DynamicBuffer Model::* range = nullptr;
+			wgpu::Buffer				   buffer;
+			uint64_t					   offset = 0;
+			std::span<const std::byte>	   data;  // into `_baked`
+		};
+
+		/// Stride of per-dispatch parameter blocks, the minimum uniform buffer offset alignment.
+		inline static constexpr size_t params_stride = 256;
+
+	private:
+		/// Allocates the pack's vertex and index sections as one range each of the shared
+		/// geometry heaps and queues their bytes; primitives only keep their offsets into them.
+		void _upload_geometry() {
+			constexpr auto vertex_usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage;
+			const auto	   vertices		= std::as_bytes(_baked.vertices());
+			const auto	   indices		= std::as_bytes(_baked.indices());
+			_buf_vertex = Render::DynamicBufferPool::shared(*_ctx, vertex_usage)
+							  .allocate(vertices.size());
+			_buf_index = Render::DynamicBufferPool::shared(*_ctx, wgpu::BufferUsage::Index)
+							 .allocate(indices.size());
+			_placed	   = _placement();
+			_pending.push_back({ .range = &Model::_buf_vertex, .data = vertices });
+			_pending.push_back({ .range = &Model::_buf_index, .data = indices });
+		}
+
+		/// Stages queued writes in order until about `budget` bytes went out, splitting them at
+		/// multiples of 4 bytes. Returns the bytes staged.
+		auto _stage_pending(Render::UploadContext& uploads, size_t budget) -> size_t {
+			size_t spent = 0;
+			while (!_pending.empty() && spent < budget) {
+				auto& write = _pending.front();
+				auto  size	= std::min(write.data.size(), budget - spent);
+				if (size < write.data.size())
+					size = std::max<size_t>(size & ~size_t { 3 }, 4);
+
+				const auto chunk = write.data.first(size);
+				if (write.range)
+					(this->*write.range).write(uploads, write.offset, chunk);
+				else
+					uploads.write(write.buffer, write.offset, chunk);
+				write.offset += size;
+				write.data	  = write.data.subspan(size);
+				spent		 += size;
+				if (write.data.empty())
+					_pending.pop_front();
+			}
+			return spent;
+		}
+
+		/// Creates a `CopyDst` buffer for `data` and queues its contents.
+		auto _queue_buffer(wgpu::BufferUsage usage, std::span<const std::byte> data)
+			-> Render::TrackedBuffer {
+			const wgpu::BufferDescriptor desc {
+				.usage = usage | wgpu::BufferUsage::CopyDst,
+				.size  = std::max<uint64_t>(data.size(), 4),
+			};
+			auto buffer = Render::create_buffer(*_ctx, desc);
+			_pending.push_back({ .buffer = buffer, .data = data });
+			return buffer;
+		}
+
+		/// Draws index `_buf_world` by node through their first instance; the scene graph only
+		/// rewrites the slots of nodes that moved.
+		void _upload_scene() {
+			constexpr auto world_usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+			_buf_world = Render::array_buffer<glm::mat4, world_usage>(*_ctx, _scene.world());
+		}
+
+		/// (Re)creates the scene bind group once the instance buffers were replaced.
+		void _bind_scene() {
+			const auto layout = Render::parsed::bindgroup_layout_from_path(
+				*_ctx,
+				"scene",
+				"shaders/Uniform.layout.json"
+			);
+
+			const auto instances = _instances.entries(1);
+
+			const auto entries = std::array {
+				wgpu::BindGroupEntry { .binding = 0, .buffer = _buf_world },
+				instances[0],
+				instances[1],
+				instances[2],
+			};
+			_bg_scene = Render::Bindgroup { *_ctx, { .layout = layout, .entries = entries } };
+		}
+
+		/// Skinned models draw from `_buf_skinned`, a copy of the vertex buffer whose positions
+		/// and normals the skinning pass rewrites every frame from the rest pose. It continues
+		/// with one more copy of a mesh per instance deforming it differently than the first.
+		/// Queues the skin and morph data and returns the bytes it recorded into `uploads` itself.
+		auto _upload_skinning(Render::UploadContext& uploads) -> size_t {
+			constexpr uint64_t stride = sizeof(Render::Vertice);
+
+			const auto meshes		= _baked.meshes();
+			uint64_t   vertex_count = _baked.vertices().size();
+			for (const auto& instance : _baked.instances()) {
+				const auto& mesh = meshes[instance.mesh];
+				vertex_count	 = std::max<uint64_t>(
+					vertex_count,
+					uint64_t { mesh.first_vertex } + mesh.vertex_count + instance.vertex_shift
+				);
+			}
+			const wgpu::BufferDescriptor skinned_desc {
+				.usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::Storage
+					   | wgpu::BufferUsage::CopyDst,
+				.size = std::max<uint64_t>(vertex_count * stride, 4),
+			};
+			_buf_skinned = Render::create_buffer(*_ctx, skinned_desc);
+			uploads.copy(
+				_buf_vertex.buffer(),
+				_buf_vertex.offset(),
+				_buf_skinned,
+				0,
+				_buf_vertex.size()
+			);
+
+			// Instances sharing mesh and shift share the copy.
+			std::set<std::pair<uint32_t, uint32_t>> copied;
+			for (const auto& instance : _baked.instances()) {
+				if (instance.vertex_shift == 0
+					|| !copied.emplace(instance.mesh, instance.vertex_shift).second)
+					continue;
+				const auto& mesh = meshes[instance.mesh];
+				uploads.copy(
+					_buf_vertex.buffer(),
+					_buf_vertex.offset() + mesh.first_vertex * stride,
+					_buf_skinned,
+					(uint64_t { mesh.first_vertex } + instance.vertex_shift) * stride,
+					mesh.vertex_count * stride
+				);
+			}
+
+			_buf_skin_vertices = _queue_buffer(
+				wgpu::BufferUsage::Storage,
+				std::as_bytes(_baked.skin_vertices())
+			);
+
+			// Starts out in the rest pose so skinning is right before the first `update()`.
+			constexpr auto palette_usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+			_palette.resize(std::max<size_t>(_baked.joints().size(), 1));
+			_update_palette();
+			_buf_palette =
+				Render::array_buffer<glm::mat4, palette_usage>(*_ctx, std::span { _palette });
+
+			// One parameter block per range.
+			const auto skinned_ranges = _baked.skinned_ranges();
+			const auto skins		  = _baked.skins();
+			const auto write_params	  = [&](std::span<std::byte> range) {
+				for (const auto& [i, skinned] : ranges::views::enumerate(skinned_ranges)) {
+					const auto params = Render::skinning_params<Render::Vertice>(
+						skinned.first_vertex,
+						skinned.output_vertex,
+						skinned.vertex_count,
+						skinned.skin != baked::no_skin ? skins[skinned.skin].first_joint : ~0u,
+						skinned.morphed
 					);
+					std::memcpy(range.data() + i * params_stride, &params, sizeof(params));
 				}
+			};
+			_buf_skinning_params = Render::mapped_buffer<wgpu::BufferUsage::Uniform>(
+				*_ctx,
+				skinned_ranges.size() * params_stride,
+				write_params
+			);
+
+			_upload_morphs();
+			_bind_skinning();
+			return skinned_desc.size;
+		}
+
+		/// (Re)creates one skinning bind group per range, over the current `_buf_vertex` range.
+		void _bind_skinning() {
+			constexpr size_t params_size = (sizeof(Render::SkinningParams) + 15) & ~size_t { 15 };
+
+			const auto layout = Render::parsed::bindgroup_layout_from_path(
+				*_ctx,
+				"skinning",
+				"shaders/Skinning.layout.json"
+			);
+			_skinned_meshes.clear();
+			for (const auto& [i, skinned] : ranges::views::enumerate(_baked.skinned_ranges())) {
+				// clang-format off
+				const auto entries = std::array {
+					wgpu::BindGroupEntry {
+						.binding = 0,
+						.buffer	 = _buf_skinning_params,
+						.offset	 = i * params_stride,
+						.size	 = params_size,
+					},
+					_buf_vertex.entry(1),
+					wgpu::BindGroupEntry { .binding = 2, .buffer = _buf_skin_vertices },
+					wgpu::BindGroupEntry { .binding = 3, .buffer = _buf_palette },
+					wgpu::BindGroupEntry { .binding = 4, .buffer = _buf_skinned },
+					wgpu::BindGroupEntry { .binding = 5, .buffer = _buf_morph_offsets },
+				};
+				// clang-format on
+				_skinned_meshes.push_back({
+					.vertex_count = skinned.vertex_count,
+					.bg_skinning =
+						Render::Bindgroup { *_ctx, { .layout = layout, .entries = entries } },
+				});
 			}
 		}
 
-		[[nodiscard]] auto _test_prmitive() const {
-			return primitive(_asset.meshes[0].primitives[0]);
+		[[nodiscard]] auto _placement() const -> Placement {
+			return {
+				.vertex		   = _buf_vertex.buffer(),
+				.vertex_offset = _buf_vertex.offset(),
+				.index		   = _buf_index.buffer(),
+				.index_offset  = _buf_index.offset(),
+			};
 		}
 
-		[[nodiscard]] auto primitive(const fastgltf::Primitive& primitive) const
-			-> Render::MeshPrimitive {
-			Render::MeshPrimitive out_primitive;
-
-			// material
-			if (primitive.materialIndex.has_value()) {
-				auto& material = _asset.materials[primitive.materialIndex.value()];
-
-				if (material.pbrData.baseColorTexture.has_value()) {
-					auto  texIndex = material.pbrData.baseColorTexture->textureIndex;
-					auto& texture  = _asset.textures[texIndex];
-					if (texture.imageIndex.has_value()) {
-						auto& image				 = _asset.images[texture.imageIndex.value()];
-						out_primitive.tex_albedo = _texture_from_image(image);
-					} else [[unlikely]] {
-						panic("texture does not have imageIndex!");
-					}
+		/// Follows the geometry ranges after a `compact()` of their pools moved them: patches
+		/// the draws, which then rewrite their indirect arguments, and rebinds the skinning.
+		void _relocate() {
+			const auto placement = _placement();
+			if (placement == _placed)
+				return;
+
+			const auto index_shift = static_cast<int64_t>(placement.index_offset)
+								   - static_cast<int64_t>(_placed.index_offset);
+			for (auto& primitive : _primitives) {
+				if (!_buf_skinned) {
+					primitive.buf_vertex		= placement.vertex;
+					primitive.buf_vertex_offset = placement.vertex_offset;
 				}
+				const int64_t index_size =
+					primitive.buf_index_format == wgpu::IndexFormat::Uint16 ? 2 : 4;
+				primitive.buf_index	  = placement.index;
+				primitive.first_index = static_cast<uint32_t>(
+					primitive.first_index + index_shift / index_size
+				);
 			}
+			if (_buf_skinned)
+				_bind_skinning();
+			_placed		 = placement;
+			_draws_dirty = !_primitives.empty();
+		}
+
+		void _update_palette() {
+			for (const auto& [i, joint] : ranges::views::enumerate(_baked.joints()))
+				_palette[i] = _scene.world()[joint.node] * joint.inverse_bind;
+		}
+
+		/// Morph deltas stay sparse on the GPU: each target is one dispatch over the vertices it
+		/// moves, and only targets with a non-zero weight are dispatched at all.
+		void _upload_morphs() {
+			const auto targets = _baked.morph_targets();
+			const auto deltas  = _baked.morph_deltas();
+
+			// Two float4 per vertex; a placeholder when nothing is morphed, the binding is static.
+			const wgpu::BufferDescriptor offsets_desc {
+				.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst,
+				.size  = deltas.empty() ? 32 : _baked.vertices().size() * 32,
+			};
+			_buf_morph_offsets = Render::create_buffer(*_ctx, offsets_desc);
+			if (targets.empty())
+				return;
+
+			_buf_morph_deltas = _queue_buffer(wgpu::BufferUsage::Storage, std::as_bytes(deltas));
+			constexpr auto weights_usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopyDst;
+			_buf_morph_weights =
+				Render::array_buffer<float, weights_usage>(*_ctx, std::span { _morph_weights });
+			_morph_dirty = true;
 
-			{	// pbr bg
+			constexpr size_t params_size  = (sizeof(Render::MorphParams) + 15) & ~size_t { 15 };
+			const auto		 write_params = [&](std::span<std::byte> range) {
+				  for (const auto& [i, target] : ranges::views::enumerate(targets)) {
+					  const Render::MorphParams params {
+						  .first_delta = target.first_delta,
+						  .delta_count = target.delta_count,
+						  .target	   = static_cast<uint32_t>(i),
+					  };
+					  std::memcpy(range.data() + i * params_stride, &params, sizeof(params));
+				  }
+			};
+			_buf_morph_params = Render::mapped_buffer<wgpu::BufferUsage::Uniform>(
+				*_ctx,
+				targets.size() * params_stride,
+				write_params
+			);
+
+			const auto layout = Render::parsed::bindgroup_layout_from_path(
+				*_ctx,
+				"morph",
+				"shaders/Morph.layout.json"
+			);
+			for (const auto& [i, target] : ranges::views::enumerate(targets)) {
 				// clang-format off
-				out_primitive.bg_pbr = Render::Bindgroup { Render::Bindgroup::Spec {
-					.layout = Render::parsed::bindgroup_layout_from_path("pbr", "shaders/Uniform.layout.json"),
-					.entries = std::array { 
-						wgpu::BindGroupEntry {
-							.binding = 0,
-							.textureView = out_primitive.tex_albedo.CreateView(),
-						},
-						wgpu::BindGroupEntry {
-							.binding = 1,
-							// .sampler = Render::linear_repeat_sampler(),
-							.sampler = Render::isotropic_sampler(wgpu::AddressMode::Repeat, wgpu::FilterMode::Nearest),
-						},
+				const auto entries = std::array {
+					wgpu::BindGroupEntry {
+						.binding = 0,
+						.buffer	 = _buf_morph_params,
+						.offset	 = i * params_stride,
+						.size	 = params_size,
 					},
-				} };
+					wgpu::BindGroupEntry { .binding = 1, .buffer = _buf_morph_deltas },
+					wgpu::BindGroupEntry { .binding = 2, .buffer = _buf_morph_weights },
+					wgpu::BindGroupEntry { .binding = 3, .buffer = _buf_morph_offsets },
+				};
 				// clang-format on
+				_morph_targets.push_back({
+					.delta_count = target.delta_count,
+					.bg_morph =
+						Render::Bindgroup { *_ctx, { .layout = layout, .entries = entries } },
+				});
 			}
+		}
 
-			{  // Vertices
-				std::vector<Render::Vertice> vertices;
-
-				if (auto it = primitive.findAttribute("POSITION");
-					it != primitive.attributes.end()) {
-					auto& accessor = _asset.accessors[it->accessorIndex];
-					vertices.resize(accessor.count);
-
-					fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
-						_asset,
-						_asset.accessors[it->accessorIndex],
-						[&](fastgltf::math::fvec3 v, size_t idx) {
-							vertices[idx].pos[0] = v.x();
-							vertices[idx].pos[1] = v.y();
-							vertices[idx].pos[2] = v.z();
-						}
-					);
-				} else [[unlikely]] {
-					panic("wtf this gltf has no attribute `POSITION`?");
-				}
-
-				if (auto it = primitive.findAttribute("TEXCOORD_0");
-					it != primitive.attributes.end()) {
-					fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec2>(
-						_asset,
-						_asset.accessors[it->accessorIndex],
-						[&](fastgltf::math::fvec2 v, size_t idx) {
-							vertices[idx].uv[0] = v.x();
-							vertices[idx].uv[1] = v.y();
-						}
-					);
-				} else [[unlikely]] {
-					panic("wtf this gltf has no attribute `TEXCOORD_0`?");
-				}
+		/// Creates what every material shares: layout, sampler and a white fallback texture.
+		void _prepare_materials() {
+			_layout = Render::parsed::bindgroup_layout_from_path(
+				*_ctx,
+				"pbr",
+				"shaders/Uniform.layout.json"
+			);
+			_sampler  = Render::trilinear_sampler(*_ctx, wgpu::AddressMode::Repeat);
+			_fallback = Render::solid_texture(*_ctx, { 255, 255, 255, 255 });
+			_materials.resize(_baked.materials().size());
+			_published.resize(_baked.primitives().size(), false);
+		}
 
-				out_primitive.buf_vertex =
-					Render::array_vertex_buffer<Render::Vertice>(std::move(vertices));
+		/// Builds the bind group of every material whose texture just became resident, then
+		/// makes the primitives using them visible.
+		void _publish() {
+			if (!_resident)
+				return;
+			_relocate();
+			const auto image_count = static_cast<int32_t>(_baked.images().size());
+			for (const auto& [i, material] : ranges::views::enumerate(_baked.materials())) {
+				// A missing image counts as none rather than as one that never becomes resident.
+				const auto image = material.albedo_image < image_count ? material.albedo_image : -1;
+				if (_materials[i].bg_pbr || image >= static_cast<int32_t>(_textures.size()))
+					continue;
+				_materials[i] = _make_material(image >= 0 ? _textures[image] : _fallback);
 			}
 
-			{  // Indices
-				auto& index_accessor = _asset.accessors[*primitive.indicesAccessor];
-				std::vector<std::size_t> indices;
-				if (primitive.indicesAccessor.has_value()) {
-					switch (index_accessor.componentType) {
-						case fastgltf::ComponentType::UnsignedByte:
-							// indices.resize(index_accessor.count * sizeof(std::byte));
-							// fastgltf::copyFromAccessor<std::uint8_t>(
-							// 	_asset,
-							// 	index_accessor,
-							// 	indices.data()
-							// );
-							panic("wgpu does not support uint8_t index yet!");
-							break;
-						case fastgltf::ComponentType::UnsignedShort:
-							indices.resize(index_accessor.count);
-							fastgltf::copyFromAccessor<std::uint16_t>(
-								_asset,
-								index_accessor,
-								indices.data()
-							);
-							out_primitive.buf_index_format = wgpu::IndexFormat::Uint16;
-							break;
-						case fastgltf::ComponentType::UnsignedInt:
-							indices.resize(index_accessor.count);
-							fastgltf::copyFromAccessor<std::uint32_t>(
-								_asset,
-								index_accessor,
-								indices.data()
-							);
-							out_primitive.buf_index_format = wgpu::IndexFormat::Uint32;
-							break;
-						default: panic("unexpected index type!"); break;
-					}
-					out_primitive.buf_index		  = Render::array_index_buffer(to_span(indices));
-					out_primitive.buf_index_count = indices.size();
-				} else [[unlikely]] {
-					panic("wtf this gltf has no indice accessor?");
+			// One draw per node instancing the mesh; skinned vertices are in model space already.
+			const auto count		 = _primitives.size();
+			const auto primitives	 = _baked.primitives();
+			const auto meshes		 = _baked.meshes();
+			const auto vertex_buffer = _buf_skinned ? _buf_skinned : _placed.vertex;
+			const auto vertex_offset = _buf_skinned ? 0 : _placed.vertex_offset;
+			const auto index_buffer	 = _placed.index;
+			const auto index_offset	 = _placed.index_offset;
+			for (const auto& [i, primitive] : ranges::views::enumerate(primitives)) {
+				if (_published[i] || !_materials[primitive.material].bg_pbr)
+					continue;
+				_published[i] = true;
+				for (const auto& instance : _baked.instances()) {
+					const auto& mesh = meshes[instance.mesh];
+					if (i < mesh.first_primitive
+						|| i >= mesh.first_primitive + mesh.primitive_count)
+						continue;
+					_primitives.push_back({
+						.buf_vertex		   = vertex_buffer,
+						.buf_vertex_offset = vertex_offset,
+						.buf_index		   = index_buffer,
+						.buf_index_count   = primitive.index_count,
+						.buf_index_format  = baked::index_format(primitive),
+						.first_index = static_cast<uint32_t>(
+							(index_offset + primitive.index_offset) / primitive.index_size
+						),
+						.base_vertex = static_cast<int32_t>(
+							primitive.first_vertex + (_buf_skinned ? instance.vertex_shift : 0)
+						),
+						.instance	 = instance.skin != baked::no_skin ? _scene.identity_index()
+																	   : instance.node,
+						.material	 = primitive.material,
+						.bg_pbr		 = _materials[primitive.material].bg_pbr,
+					});
 				}
 			}
 
-			return out_primitive;
-		}
+			if (_primitives.size() == count)
+				return;
+			_draws_dirty = true;
 
-	private:
-		[[nodiscard]] auto _texture_from_image(const fastgltf::Image& image) const
-			-> wgpu::Texture {
-			return _texture_from_image(Render::WgpuContext::global(), image);
+			// Keep primitives sharing a material (then an index format) adjacent so the pass can
+			// skip rebinding them.
+			std::ranges::stable_sort(_primitives, {}, [](const Render::MeshPrimitive& primitive) {
+				return std::pair { primitive.material, primitive.buf_index_format };
+			});
 		}
 
-		[[nodiscard]] auto _texture_from_image(
-			const Render::WgpuContext& ctx, const fastgltf::Image& image
-		) const -> wgpu::Texture {
-			wgpu::Texture texture;
-			// spdlog::info("image name: {}", image.name);
-			// spdlog::info("image data type: {}", image.data.index());
-			std::visit(
-				fastgltf::visitor {
-					[&](const fastgltf::sources::URI& filePath) {
-						assert(
-							filePath.fileByteOffset == 0
-						);	// We don't support offsets with stbi.
-						assert(
-							filePath.uri.isLocalPath()
-						);	// We're only capable of loading local files.
-						int				  width, height, nrChannels;
-
-						const std::string path(
-							filePath.uri.path().begin(),
-							filePath.uri.path().end()
-						);	// Thanks C++.
-						unsigned char* data =
-							stbi_load(path.c_str(), &width, &height, &nrChannels, 4);
-
-						texture = texture_from_image(
-							ctx,
-							Render::ImageInfo {
-								{ reinterpret_cast<char*>(data),
-								  std::strlen(reinterpret_cast<char*>(data)) },
-								static_cast<uint32_t>(width),
-								static_cast<uint32_t>(height),
-						}
-						);
-
-						stbi_image_free(data);
-					},
-					[&](const fastgltf::sources::Array& vector) {
-						int			   width, height, nrChannels;
-						unsigned char* data = stbi_load_from_memory(
-							reinterpret_cast<const stbi_uc*>(vector.bytes.data()),
-							static_cast<int>(vector.bytes.size()),
-							&width,
-							&height,
-							&nrChannels,
-							4
-						);
-						texture = texture_from_image(
-							ctx,
-							Render::ImageInfo {
-								{ reinterpret_cast<char*>(data),
-								  std::strlen(reinterpret_cast<char*>(data)) },
-								static_cast<uint32_t>(width),
-								static_cast<uint32_t>(height),
-						}
-						);
-						stbi_image_free(data);
-					},
-					[&](const fastgltf::sources::BufferView& view) {
-						auto& bufferView = _asset.bufferViews[view.bufferViewIndex];
-						auto& buffer	 = _asset.buffers[bufferView.bufferIndex];
-						// Yes, we've already loaded every buffer into some GL buffer. However, with
-						// GL it's simpler to just copy the buffer data again for the texture.
-						// Besides, this is just an example.
-						std::visit(
-							fastgltf::visitor {
-								// We only care about VectorWithMime here, because we specify
-								// LoadExternalBuffers, meaning
-								// all buffers are already loaded into a vector.
-								[&](const fastgltf::sources::Array& vector) {
-									int			   width, height, nrChannels;
-									unsigned char* data = stbi_load_from_memory(
-										reinterpret_cast<const stbi_uc*>(
-											vector.bytes.data() + bufferView.byteOffset
-										),
-										static_cast<int>(bufferView.byteLength),
-										&width,
-										&height,
-										&nrChannels,
-										4
-									);
-									// spdlog::info(
-									// 	"image info: {}, {}, {}",
-									// 	width,
-									// 	height,
-									// 	nrChannels
-									// );
-									texture = texture_from_image(
-										ctx,
-										Render::ImageInfo {
-											.data	= { reinterpret_cast<char*>(data),
-														//   std::strlen(reinterpret_cast<char*>(data))
-														static_cast<size_t>(width * height * 4) },
-											.width	= static_cast<uint32_t>(width),
-											.height = static_cast<uint32_t>(height),
-									}
-									);
-									stbi_image_free(data);
-								},
-								[](auto&& arg) { panic("unexpected image buffer view!"); },
-							},
-							buffer.data
-						);
-					},
-					[](auto&& arg) { panic("unexpected image type!"); },
+		[[nodiscard]] auto _make_material(wgpu::Texture albedo) const -> Render::PbrMaterial {
+			// clang-format off
+			const auto entries = std::array {
+				wgpu::BindGroupEntry {
+					.binding	 = 0,
+					.textureView = albedo.CreateView(),
 				},
-				image.data
-			);
-			return texture;
+				wgpu::BindGroupEntry {
+					.binding = 1,
+					.sampler = _sampler,
+				},
+			};
+			// clang-format on
+			return Render::PbrMaterial {
+				.tex_albedo = albedo,
+				.smp_albedo = _sampler,
+				.bg_pbr =
+					Render::Bindgroup { *_ctx, { .layout = _layout, .entries = entries } },
+			};
 		}
 
 	private:
-		fastgltf::Asset _asset;
+		const Render::WgpuContext*			_ctx;
+		std::string							_name;  // owner of its GPU memory
+		BakedModel							_baked;
+
+		SceneGraph							  _scene;
+		NodeConstraintSolver				  _constraints;
+		SpringBoneSolver					  _springs;
+		std::chrono::steady_clock::time_point _last_update = std::chrono::steady_clock::now();
+		Render::TrackedBuffer				  _buf_world;
+		wgpu::BindGroup						  _bg_scene;
+		Render::InstanceSet					  _instances;
+		uint64_t							  _scene_generation = 0;  // bound in `_bg_scene`
+		bool								  _draws_dirty	  = false;
+
+		Render::DynamicBuffer				_buf_vertex;
+		Render::DynamicBuffer				_buf_index;
+		Placement							_placed;
+		std::deque<PendingWrite>			_pending;
+		bool								_resident = false;	// all but textures staged
+		wgpu::BindGroupLayout				_layout;
+		wgpu::Sampler						_sampler;
+		Render::TrackedTexture				_fallback;
+		std::vector<Render::TrackedTexture>	_textures;
+		std::vector<Render::PbrMaterial>	_materials;
+		std::vector<bool>					_published;
+		std::vector<Render::MeshPrimitive>	_primitives;
+
+		Render::TrackedBuffer				_buf_skinned;
+		Render::TrackedBuffer				_buf_skin_vertices;
+		Render::TrackedBuffer				_buf_palette;
+		Render::TrackedBuffer				_buf_skinning_params;
+		std::vector<glm::mat4>				_palette;
+		std::vector<Render::SkinnedMesh>	_skinned_meshes;
+
+		Render::TrackedBuffer				_buf_morph_deltas;
+		Render::TrackedBuffer				_buf_morph_weights;
+		Render::TrackedBuffer				_buf_morph_params;
+		Render::TrackedBuffer				_buf_morph_offsets;
+		std::vector<float>					_morph_weights;
+		bool								_morph_dirty = false;
+		std::vector<Render::MorphTarget>	_morph_targets;
+		std::vector<Render::MorphTarget>	_active_morphs;
 	};
-}  // namespace dvdbchar
\ No newline at end of file
+}  // namespace dvdbchar
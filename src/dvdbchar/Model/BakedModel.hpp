@@ -0,0 +1,633 @@
+#pragma once
+
+#include "dvdbchar/MappedFile.hpp"
+#include "dvdbchar/Render/Pipeline.hpp"
+#include "dvdbchar/Render/Texture.hpp"
+#include "dvdbchar/Render/TextureCompression.hpp"
+#include "dvdbchar/Utils.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace dvdbchar {
+	/// On-disk layout of a baked model pack. Every section is 16-byte aligned and holds data in
+	/// the exact layout it is uploaded with, so loading is `mmap` + checks + upload.
+	///
+	/// Bump `version` whenever any struct below or `Render::Vertice` changes.
+	namespace baked {
+		inline constexpr std::array<char, 8> magic = { 'D', 'V', 'D', 'B', 'P', 'A', 'K', '\0' };
+		inline constexpr uint32_t			 version   = 13;
+		inline constexpr size_t				 alignment = 16;
+
+		struct Section {
+			uint64_t offset = 0;  // bytes from the start of the file
+			uint64_t size	= 0;  // bytes
+		};
+
+		/// The .vrm/.glb a pack was baked from. Staleness is decided on size and modification
+		/// time, so loading never reads the source.
+		struct Source {
+			uint64_t size  = 0;
+			int64_t	 mtime = 0;	 // `file_time_type` ticks
+
+			[[nodiscard]] auto same_file(const Source& another) const -> bool {
+				return size == another.size && mtime == another.mtime;
+			}
+		};
+
+		/// Size and modification time of `path`.
+		[[nodiscard]] inline auto source_of(const std::filesystem::path& path)
+			-> std::optional<Source> {
+			std::error_code ec;
+			const auto		size  = std::filesystem::file_size(path, ec);
+			const auto		mtime = std::filesystem::last_write_time(path, ec);
+			if (ec)
+				return std::nullopt;
+			return Source {
+				.size  = size,
+				.mtime = static_cast<int64_t>(mtime.time_since_epoch().count()),
+			};
+		}
+
+		struct Header {
+			std::array<char, 8> magic;
+			uint32_t			version;
+			uint32_t			vertex_stride;
+			Source				source;
+			uint64_t			vertex_layout;	// `vertex_layout_hash()` of the baking build
+			uint64_t			payload_hash;	// xxhash64 of everything after the header
+			Section				primitives;
+			Section				materials;
+			Section				images;
+			Section				vertices;
+			Section				indices;
+			Section				pixels;
+			Section				nodes;
+			Section				skins;
+			Section				joints;
+			Section				skin_vertices;
+			Section				skinned_ranges;
+			Section				meshes;
+			Section				instances;
+			Section				morph_targets;
+			Section				morph_deltas;
+			Section				springs;
+			Section				spring_joints;
+			Section				spring_colliders;
+			Section				colliders;
+			Section				constraints;
+
+			[[nodiscard]] auto sections() const {
+				return std::array {
+					primitives,	  materials,	 images,	   vertices,	   indices,
+					pixels,		  nodes,		 skins,		   joints,		   skin_vertices,
+					skinned_ranges, meshes,		  instances,	 morph_targets, morph_deltas,
+					springs,		spring_joints, spring_colliders, colliders,	 constraints,
+				};
+			}
+		};
+
+		struct Primitive {
+			uint32_t first_vertex;
+			uint32_t vertex_count;
+			uint64_t index_offset;	// bytes into the index section, 4-byte aligned
+			uint32_t index_count;
+			uint32_t index_size;  // 2 or 4
+			uint32_t material;
+			uint32_t _pad;
+		};
+
+		struct Material {
+			int32_t albedo_image = -1;	// -1: no texture
+		};
+
+		enum class ImageFormat : uint32_t {
+			rgba8,
+			bc7,  // dimensions are multiples of 4
+		};
+
+		struct Image {
+			uint32_t	width;
+			uint32_t	height;
+			uint32_t	mip_count;
+			ImageFormat format;
+			uint64_t pixel_offset;	// bytes into the pixel section, mips tightly packed
+			uint64_t pixel_size;
+		};
+
+		/// Scene node with its local transform. Nodes are sorted so parents precede children.
+		struct Node {
+			glm::vec3 translation;
+			int32_t	  parent;  // -1: root
+			glm::quat rotation;
+			glm::vec3 scale;
+			uint32_t  _pad;
+		};
+
+		struct Skin {
+			uint32_t first_joint;
+			uint32_t joint_count;
+		};
+
+		struct Joint {
+			glm::mat4 inverse_bind;
+			uint32_t  node;
+			uint32_t  _pad[3];
+		};
+
+		/// Parallel to the vertex section; zero for vertices of unskinned primitives, which no
+		/// range with a skin covers.
+		struct SkinVertex {
+			std::array<uint16_t, 4> joints;	  // into the joints of the skin
+			std::array<uint16_t, 4> weights;  // unorm16, summing to 1
+		};
+
+		inline constexpr uint32_t no_skin = ~uint32_t { 0 };
+
+		/// Vertices of one deformed mesh instance, contiguous in the vertex section, and where
+		/// they land among the deformed vertices. Ranges of meshes with morph targets but no
+		/// skin, or of their primitives without skin attributes, use `no_skin`.
+		struct SkinnedRange {
+			uint32_t first_vertex;
+			uint32_t vertex_count;
+			uint32_t skin;
+			uint32_t morphed;		 // 1 when the mesh has morph targets
+			uint32_t output_vertex;	 // `first_vertex` unless deformed into a copy of the mesh
+			uint32_t _pad;
+		};
+
+		/// One glTF mesh. Its morph targets are indexed like the mesh's `weights`.
+		struct Mesh {
+			uint32_t first_primitive;
+			uint32_t primitive_count;
+			uint32_t first_target;
+			uint32_t target_count;
+			uint32_t first_vertex;
+			uint32_t vertex_count;
+		};
+
+		/// A node drawing a mesh. Skinned instances are already in model space once skinned, so
+		/// they ignore the node's transform. Nodes deforming a mesh differently than the first
+		/// one using it draw a copy past the vertex section, `vertex_shift` vertices further.
+		struct Instance {
+			uint32_t node;
+			uint32_t mesh;
+			uint32_t skin;	// `no_skin` if not skinned
+			uint32_t vertex_shift;
+		};
+
+		/// Sparse morph target: only vertices it actually moves have a delta.
+		struct MorphTarget {
+			uint32_t first_delta;
+			uint32_t delta_count;
+			float	 default_weight;
+			uint32_t _pad;
+		};
+
+		struct MorphDelta {
+			glm::vec3 position;
+			uint32_t  vertex;  // into the vertex section
+			glm::vec3 normal;
+			uint32_t  _pad;
+		};
+
+		/// VRMC_springBone chain. Consecutive joints are parent and child.
+		struct Spring {
+			uint32_t first_joint;
+			uint32_t joint_count;
+			uint32_t first_collider;  // into the spring collider section
+			uint32_t collider_count;
+		};
+
+		struct SpringJoint {
+			uint32_t  node;
+			float	  hit_radius;
+			float	  stiffness;
+			float	  drag_force;
+			glm::vec3 gravity;	// direction scaled by power
+			uint32_t  _pad;
+		};
+
+		/// Capsule from `offset` to `tail` in the space of `node`; spheres have `tail == offset`.
+		struct Collider {
+			glm::vec3 offset;
+			float	  radius;
+			glm::vec3 tail;
+			uint32_t  node;
+		};
+
+		enum class ConstraintKind : uint32_t { roll, aim, rotation };
+
+		/// A `VRMC_node_constraint` driving the rotation of `node` from `source`. Stored in
+		/// evaluation order: after every constraint it reads the result of.
+		struct Constraint {
+			glm::vec3	   axis;  // roll or aim axis, in the space of `node`
+			float		   weight;
+			uint32_t	   node;
+			uint32_t	   source;
+			ConstraintKind kind;
+			uint32_t	   _pad;
+		};
+
+		/// `translate * rotate * scale`, written out so batches of nodes compose without
+		/// intermediate matrix products.
+		[[nodiscard]] inline auto local_matrix(const Node& node) -> glm::mat4 {
+			const auto& q  = node.rotation;
+			const auto& s  = node.scale;
+			const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+			const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+			const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+			return {
+				glm::vec4 { 1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f } * s.x,
+				glm::vec4 { 2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f } * s.y,
+				glm::vec4 { 2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f } * s.z,
+				glm::vec4 { node.translation, 1.f },
+			};
+		}
+
+		[[nodiscard]] inline constexpr auto mip_extent(uint32_t base, uint32_t level) -> uint32_t {
+			return std::max(1u, base >> level);
+		}
+
+		[[nodiscard]] inline constexpr auto mip_count(uint32_t width, uint32_t height) -> uint32_t {
+			return std::bit_width(std::max(width, height));
+		}
+
+		[[nodiscard]] inline constexpr auto level_size(
+			ImageFormat format, uint32_t width, uint32_t height
+		) -> size_t {
+			return format == ImageFormat::bc7 ? Render::bc7_size(width, height)
+											  : size_t { width } * height * 4;
+		}
+
+		[[nodiscard]] inline constexpr auto align_up(size_t size, size_t align = alignment)
+			-> size_t {
+			return (size + align - 1) / align * align;
+		}
+
+		/// Fingerprint of `Render::Vertice`'s attribute formats and offsets, so packs baked with
+		/// another vertex layout are rejected even when the stride happens to match.
+		[[nodiscard]] inline auto vertex_layout_hash() -> uint64_t {
+			std::vector<uint64_t> fields;
+			for (const auto& attribute : Render::Vertice::vertex_attribute())
+				fields.insert(
+					fields.end(),
+					{
+						static_cast<uint64_t>(attribute.format),
+						attribute.offset,
+						attribute.shaderLocation,
+					}
+				);
+			return xxhash64(std::as_bytes(std::span { fields }));
+		}
+
+		[[nodiscard]] inline auto index_format(const Primitive& primitive) -> wgpu::IndexFormat {
+			return primitive.index_size == 2 ? wgpu::IndexFormat::Uint16
+											 : wgpu::IndexFormat::Uint32;
+		}
+	}  // namespace baked
+
+	class BakedModel {
+	public:
+		using Storage = std::variant<MappedFile, std::vector<std::byte>>;
+
+		/// Accumulates a model in pack layout. `finish()` serializes it into a `BakedModel`.
+		struct Writer {
+			std::vector<baked::Primitive>	 primitives;
+			std::vector<baked::Material>	 materials;
+			std::vector<baked::Image>		 images;
+			std::vector<Render::Vertice>	 vertices;
+			std::vector<std::byte>			 indices;
+			std::vector<std::byte>			 pixels;
+			std::vector<baked::Node>		 nodes;
+			std::vector<baked::Skin>		 skins;
+			std::vector<baked::Joint>		 joints;
+			std::vector<baked::SkinVertex>	 skin_vertices;
+			std::vector<baked::SkinnedRange> skinned_ranges;
+			std::vector<baked::Mesh>		 meshes;
+			std::vector<baked::Instance>	 instances;
+			std::vector<baked::MorphTarget>	 morph_targets;
+			std::vector<baked::MorphDelta>	 morph_deltas;
+			std::vector<baked::Spring>		 springs;
+			std::vector<baked::SpringJoint>	 spring_joints;
+			std::vector<uint32_t>			 spring_colliders;
+			std::vector<baked::Collider>	 colliders;
+			std::vector<baked::Constraint>	 constraints;
+
+			[[nodiscard]] auto finish(const baked::Source& source) && -> BakedModel {
+				std::vector<std::byte> blob(baked::align_up(sizeof(baked::Header)));
+				baked::Header		   header {
+							   .magic		  = baked::magic,
+							   .version		  = baked::version,
+							   .vertex_stride = sizeof(Render::Vertice),
+							   .source		  = source,
+							   .vertex_layout = baked::vertex_layout_hash(),
+				};
+
+				const auto append = [&](std::span<const std::byte> bytes) -> baked::Section {
+					const baked::Section section { blob.size(), bytes.size() };
+					blob.resize(baked::align_up(blob.size() + bytes.size()));
+					std::memcpy(blob.data() + section.offset, bytes.data(), bytes.size());
+					return section;
+				};
+				// Sized up front so appending never reallocates, which would briefly hold the pack
+				// twice.
+				blob.reserve(
+					blob.size() + baked::align_up(primitives.size() * sizeof(baked::Primitive))
+					+ baked::align_up(materials.size() * sizeof(baked::Material))
+					+ baked::align_up(images.size() * sizeof(baked::Image))
+					+ baked::align_up(vertices.size() * sizeof(Render::Vertice))
+					+ baked::align_up(indices.size()) + baked::align_up(pixels.size())
+					+ baked::align_up(nodes.size() * sizeof(baked::Node))
+					+ baked::align_up(skins.size() * sizeof(baked::Skin))
+					+ baked::align_up(joints.size() * sizeof(baked::Joint))
+					+ baked::align_up(skin_vertices.size() * sizeof(baked::SkinVertex))
+					+ baked::align_up(skinned_ranges.size() * sizeof(baked::SkinnedRange))
+					+ baked::align_up(meshes.size() * sizeof(baked::Mesh))
+					+ baked::align_up(instances.size() * sizeof(baked::Instance))
+					+ baked::align_up(morph_targets.size() * sizeof(baked::MorphTarget))
+					+ baked::align_up(morph_deltas.size() * sizeof(baked::MorphDelta))
+					+ baked::align_up(springs.size() * sizeof(baked::Spring))
+					+ baked::align_up(spring_joints.size() * sizeof(baked::SpringJoint))
+					+ baked::align_up(spring_colliders.size() * sizeof(uint32_t))
+					+ baked::align_up(colliders.size() * sizeof(baked::Collider))
+					+ baked::align_up(constraints.size() * sizeof(baked::Constraint))
+				);
+				header.primitives		= append(std::as_bytes(std::span { primitives }));
+				header.materials		= append(std::as_bytes(std::span { materials }));
+				header.images			= append(std::as_bytes(std::span { images }));
+				header.vertices			= append(std::as_bytes(std::span { vertices }));
+				header.indices			= append(indices);
+				header.pixels			= append(pixels);
+				header.nodes			= append(std::as_bytes(std::span { nodes }));
+				header.skins			= append(std::as_bytes(std::span { skins }));
+				header.joints			= append(std::as_bytes(std::span { joints }));
+				header.skin_vertices	= append(std::as_bytes(std::span { skin_vertices }));
+				header.skinned_ranges	= append(std::as_bytes(std::span { skinned_ranges }));
+				header.meshes			= append(std::as_bytes(std::span { meshes }));
+				header.instances		= append(std::as_bytes(std::span { instances }));
+				header.morph_targets	= append(std::as_bytes(std::span { morph_targets }));
+				header.morph_deltas		= append(std::as_bytes(std::span { morph_deltas }));
+				header.springs			= append(std::as_bytes(std::span { springs }));
+				header.spring_joints	= append(std::as_bytes(std::span { spring_joints }));
+				header.spring_colliders	= append(std::as_bytes(std::span { spring_colliders }));
+				header.colliders		= append(std::as_bytes(std::span { colliders }));
+				header.constraints		= append(std::as_bytes(std::span { constraints }));
+
+				header.payload_hash =
+					xxhash64(std::span { blob }.subspan(baked::align_up(sizeof(baked::Header))));
+				std::memcpy(blob.data(), &header, sizeof(header));
+
+				return BakedModel { std::move(blob) };
+			}
+		};
+
+	public:
+		BakedModel(BakedModel&&) noexcept			 = default;
+		BakedModel& operator=(BakedModel&&) noexcept = default;
+
+	public:
+		[[nodiscard]] inline static auto pack_path_of(const std::filesystem::path& source)
+			-> std::filesystem::path {
+			auto path  = source;
+			path	  += ".baked";
+			return path;
+		}
+
+		/// Maps the pack at `path`. Returns `std::nullopt` when it is missing, from another format
+		/// version or baked from another version of `source`, checked on the header alone, or
+		/// when its payload fails the checksum. The renderer trusts every index in a pack, so
+		/// the checksum reads all of it; `Model::load_async()` keeps that on the loader thread.
+		[[nodiscard]] inline static auto load(
+			const std::filesystem::path& path, const baked::Source& source
+		) -> std::optional<BakedModel> {
+			auto file = MappedFile::open(path);
+			if (!file)
+				return std::nullopt;
+
+			const auto bytes = file->bytes();
+			if (bytes.size() < baked::align_up(sizeof(baked::Header))) {
+				spdlog::warn("baked model `{}` is truncated, rebaking.", path.string());
+				return std::nullopt;
+			}
+
+			baked::Header header;
+			std::memcpy(&header, bytes.data(), sizeof(header));
+			if (header.magic != baked::magic || header.version != baked::version
+				|| header.vertex_stride != sizeof(Render::Vertice)
+				|| header.vertex_layout != baked::vertex_layout_hash()) {
+				spdlog::info("baked model `{}` has an outdated format, rebaking.", path.string());
+				return std::nullopt;
+			}
+			if (!header.source.same_file(source)) {
+				spdlog::info("baked model `{}` is stale, rebaking.", path.string());
+				return std::nullopt;
+			}
+
+			const auto in_bounds = [&](const baked::Section& section) {
+				return section.offset % baked::alignment == 0 && section.offset <= bytes.size()
+					&& section.size <= bytes.size() - section.offset;
+			};
+			if (!std::ranges::all_of(header.sections(), in_bounds)) {
+				spdlog::warn("baked model `{}` is corrupted, rebaking.", path.string());
+				return std::nullopt;
+			}
+
+			const auto payload = bytes.subspan(baked::align_up(sizeof(baked::Header)));
+			if (xxhash64(payload) != header.payload_hash) {
+				spdlog::warn("baked model `{}` fails its checksum, rebaking.", path.string());
+				return std::nullopt;
+			}
+
+			// A pack breaking these would never finish loading, even when it is intact.
+			auto	   model		= BakedModel { std::move(*file) };
+			const auto images		= static_cast<int64_t>(model.images().size());
+			const auto materials	= model.materials().size();
+			const auto bad_image	= [&](int32_t image) { return image >= images; };
+			const auto bad_material = [&](uint32_t material) { return material >= materials; };
+			if (std::ranges::any_of(model.materials(), bad_image, &baked::Material::albedo_image)
+				|| std::ranges::any_of(
+					model.primitives(),
+					bad_material,
+					&baked::Primitive::material
+				)) {
+				spdlog::warn("baked model `{}` references missing data, rebaking.", path.string());
+				return std::nullopt;
+			}
+			return model;
+		}
+
+		/// Writes the pack next to a temporary name first so a crash never leaves a torn file.
+		auto save(const std::filesystem::path& path) const -> bool {
+			auto		  tmp  = path;
+			tmp			  += ".tmp";
+			std::ofstream out { tmp, std::ios::binary | std::ios::trunc };
+			if (!out.is_open())
+				return false;
+
+			const auto bytes = this->bytes();
+			out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+			out.close();
+			if (!out)
+				return false;
+
+			std::error_code ec;
+			std::filesystem::rename(tmp, path, ec);
+			return !ec;
+		}
+
+	public:
+		[[nodiscard]] auto bytes() const -> std::span<const std::byte> {
+			return std::visit(
+				[](const auto& storage) -> std::span<const std::byte> {
+					return { storage.data(), storage.size() };
+				},
+				_storage
+			);
+		}
+
+		[[nodiscard]] auto header() const -> const baked::Header& {
+			return *reinterpret_cast<const baked::Header*>(bytes().data());
+		}
+
+		[[nodiscard]] auto primitives() const -> std::span<const baked::Primitive> {
+			return _section<baked::Primitive>(header().primitives);
+		}
+
+		[[nodiscard]] auto materials() const -> std::span<const baked::Material> {
+			return _section<baked::Material>(header().materials);
+		}
+
+		[[nodiscard]] auto images() const -> std::span<const baked::Image> {
+			return _section<baked::Image>(header().images);
+		}
+
+		[[nodiscard]] auto vertices() const -> std::span<const Render::Vertice> {
+			return _section<Render::Vertice>(header().vertices);
+		}
+
+		[[nodiscard]] auto indices() const -> std::span<const std::byte> {
+			return _section<std::byte>(header().indices);
+		}
+
+		[[nodiscard]] auto nodes() const -> std::span<const baked::Node> {
+			return _section<baked::Node>(header().nodes);
+		}
+
+		[[nodiscard]] auto skins() const -> std::span<const baked::Skin> {
+			return _section<baked::Skin>(header().skins);
+		}
+
+		[[nodiscard]] auto joints() const -> std::span<const baked::Joint> {
+			return _section<baked::Joint>(header().joints);
+		}
+
+		[[nodiscard]] auto skin_vertices() const -> std::span<const baked::SkinVertex> {
+			return _section<baked::SkinVertex>(header().skin_vertices);
+		}
+
+		[[nodiscard]] auto skinned_ranges() const -> std::span<const baked::SkinnedRange> {
+			return _section<baked::SkinnedRange>(header().skinned_ranges);
+		}
+
+		[[nodiscard]] auto meshes() const -> std::span<const baked::Mesh> {
+			return _section<baked::Mesh>(header().meshes);
+		}
+
+		[[nodiscard]] auto instances() const -> std::span<const baked::Instance> {
+			return _section<baked::Instance>(header().instances);
+		}
+
+		[[nodiscard]] auto morph_targets() const -> std::span<const baked::MorphTarget> {
+			return _section<baked::MorphTarget>(header().morph_targets);
+		}
+
+		[[nodiscard]] auto morph_deltas() const -> std::span<const baked::MorphDelta> {
+			return _section<baked::MorphDelta>(header().morph_deltas);
+		}
+
+		[[nodiscard]] auto springs() const -> std::span<const baked::Spring> {
+			return _section<baked::Spring>(header().springs);
+		}
+
+		[[nodiscard]] auto spring_joints() const -> std::span<const baked::SpringJoint> {
+			return _section<baked::SpringJoint>(header().spring_joints);
+		}
+
+		[[nodiscard]] auto spring_colliders() const -> std::span<const uint32_t> {
+			return _section<uint32_t>(header().spring_colliders);
+		}
+
+		[[nodiscard]] auto colliders() const -> std::span<const baked::Collider> {
+			return _section<baked::Collider>(header().colliders);
+		}
+
+		[[nodiscard]] auto constraints() const -> std::span<const baked::Constraint> {
+			return _section<baked::Constraint>(header().constraints);
+		}
+
+		[[nodiscard]] auto vertices_of(const baked::Primitive& primitive) const
+			-> std::span<const Render::Vertice> {
+			return vertices().subspan(primitive.first_vertex, primitive.vertex_count);
+		}
+
+		[[nodiscard]] auto indices_of(const baked::Primitive& primitive) const
+			-> std::span<const std::byte> {
+			// Index runs are padded to 4 bytes so they can be handed to `WriteBuffer` as is.
+			return indices().subspan(
+				primitive.index_offset,
+				baked::align_up(size_t { primitive.index_count } * primitive.index_size, 4)
+			);
+		}
+
+		[[nodiscard]] auto mip(const baked::Image& image, uint32_t level) const
+			-> Render::ImageInfo {
+			const auto pixels = _section<char>(header().pixels);
+
+			size_t	   offset = image.pixel_offset;
+			for (uint32_t i = 0; i < level; ++i)
+				offset += baked::level_size(
+					image.format,
+					baked::mip_extent(image.width, i),
+					baked::mip_extent(image.height, i)
+				);
+
+			const auto width  = baked::mip_extent(image.width, level);
+			const auto height = baked::mip_extent(image.height, level);
+			return {
+				.data	= pixels.subspan(offset, baked::level_size(image.format, width, height)),
+				.width	= width,
+				.height = height,
+				.format = image.format == baked::ImageFormat::bc7
+							? wgpu::TextureFormat::BC7RGBAUnorm
+							: wgpu::TextureFormat::RGBA8Unorm,
+			};
+		}
+
+	private:
+		explicit BakedModel(Storage&& storage) : _storage(std::move(storage)) {}
+
+		template<typename T>
+		[[nodiscard]] auto _section(const baked::Section& section) const -> std::span<const T> {
+			return {
+				reinterpret_cast<const T*>(bytes().data() + section.offset),
+				section.size / sizeof(T),
+			};
+		}
+
+	private:
+		Storage _storage;
+	};
+}  // namespace dvdbchar
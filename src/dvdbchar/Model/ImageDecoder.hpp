@@ -0,0 +1,149 @@
+#pragma once
+
+#include "dvdbchar/Stb.hpp"
+#include "dvdbchar/Utils.hpp"
+
+#include <fastgltf/core.hpp>
+#include <fastgltf/types.hpp>
+#include <fastgltf/util.hpp>
+#include <spdlog/spdlog.h>
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+#include <range/v3/all.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace dvdbchar {
+	struct DecodedImage {
+		std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> pixels { nullptr, stbi_image_free };
+		uint32_t											 width	= 0;
+		uint32_t											 height = 0;
+		std::chrono::duration<double, std::milli>			 decode_time {};
+
+		[[nodiscard]] auto valid() const -> bool { return pixels != nullptr; }
+
+		[[nodiscard]] auto byte_size() const -> size_t {
+			return static_cast<size_t>(width) * height * 4;
+		}
+
+		[[nodiscard]] auto data() const -> std::span<char> {
+			return { reinterpret_cast<char*>(pixels.get()), byte_size() };
+		}
+	};
+
+	namespace details::image_decoder {
+		inline auto decode_memory(std::span<const std::byte> bytes) -> DecodedImage {
+			DecodedImage image;
+			int			 width, height, channels;
+			image.pixels.reset(stbi_load_from_memory(
+				reinterpret_cast<const stbi_uc*>(bytes.data()),
+				static_cast<int>(bytes.size()),
+				&width,
+				&height,
+				&channels,
+				4
+			));
+			if (image.valid()) {
+				image.width	 = static_cast<uint32_t>(width);
+				image.height = static_cast<uint32_t>(height);
+			}
+			return image;
+		}
+
+		inline auto decode_file(const std::string& path) -> DecodedImage {
+			DecodedImage image;
+			int			 width, height, channels;
+			image.pixels.reset(stbi_load(path.c_str(), &width, &height, &channels, 4));
+			if (image.valid()) {
+				image.width	 = static_cast<uint32_t>(width);
+				image.height = static_cast<uint32_t>(height);
+			}
+			return image;
+		}
+	}  // namespace details::image_decoder
+
+	/// Decodes a single glTF image to tightly packed RGBA8. Thread-safe: only reads `asset`.
+	inline auto decode_image(const fastgltf::Asset& asset, const fastgltf::Image& image)
+		-> DecodedImage {
+		using namespace details::image_decoder;
+
+		const auto	 start = std::chrono::steady_clock::now();
+		DecodedImage decoded;
+		std::visit(
+			fastgltf::visitor {
+				[&](const fastgltf::sources::URI& file) {
+					assert(file.fileByteOffset == 0);  // We don't support offsets with stbi.
+					assert(file.uri.isLocalPath());	   // We're only capable of loading local files.
+					decoded = decode_file({ file.uri.path().begin(), file.uri.path().end() });
+				},
+				[&](const fastgltf::sources::Array& array) {
+					decoded = decode_memory({ array.bytes.data(), array.bytes.size() });
+				},
+				[&](const fastgltf::sources::BufferView& view) {
+					auto& buffer_view = asset.bufferViews[view.bufferViewIndex];
+					auto& buffer	  = asset.buffers[buffer_view.bufferIndex];
+					// `LoadExternalBuffers` guarantees every buffer is already an in-memory array.
+					std::visit(
+						fastgltf::visitor {
+							[&](const fastgltf::sources::Array& array) {
+								decoded = decode_memory({
+									array.bytes.data() + buffer_view.byteOffset,
+									buffer_view.byteLength,
+								});
+							},
+							[](auto&&) { panic("unexpected image buffer view!"); },
+						},
+						buffer.data
+					);
+				},
+				[](auto&&) { panic("unexpected image type!"); },
+			},
+			image.data
+		);
+		decoded.decode_time = std::chrono::steady_clock::now() - start;
+
+		if (!decoded.valid()) [[unlikely]]
+			panic(std::format("failed to decode image `{}`: {}", image.name, stbi_failure_reason()));
+		return decoded;
+	}
+
+	/// Decodes every image of `asset` concurrently on a worker pool. The result is indexed like
+	/// `asset.images`, so texture lookups can keep using `fastgltf::Texture::imageIndex`.
+	inline auto decode_images(
+		const fastgltf::Asset& asset,
+		uint32_t			   workers = std::max(1u, std::thread::hardware_concurrency())
+	) -> std::vector<DecodedImage> {
+		std::vector<DecodedImage> decoded(asset.images.size());
+		if (decoded.empty())
+			return decoded;
+
+		const auto				  start = std::chrono::steady_clock::now();
+		exec::static_thread_pool  pool { std::min<uint32_t>(workers, decoded.size()) };
+		stdexec::sync_wait(
+			stdexec::schedule(pool.get_scheduler())	 //
+			| stdexec::bulk(stdexec::par, decoded.size(), [&](size_t i) {
+				  decoded[i] = decode_image(asset, asset.images[i]);
+			  })
+		);
+		const std::chrono::duration<double, std::milli> elapsed =
+			std::chrono::steady_clock::now() - start;
+
+		for (const auto& [i, image] : ranges::views::enumerate(decoded))
+			spdlog::info(
+				"image[{}] `{}` ({}x{}) decoded in {:.2f} ms",
+				i,
+				asset.images[i].name,
+				image.width,
+				image.height,
+				image.decode_time.count()
+			);
+		spdlog::info("decoded {} images in {:.2f} ms", decoded.size(), elapsed.count());
+
+		return decoded;
+	}
+}  // namespace dvdbchar
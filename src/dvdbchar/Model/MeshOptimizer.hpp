@@ -0,0 +1,327 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace dvdbchar {
+	/// Post-transform cache efficiency of an index buffer, simulated with a FIFO cache.
+	struct VertexCacheStats {
+		size_t misses	= 0;
+		size_t faces	= 0;
+		size_t vertices = 0;  // unique vertices referenced
+
+		/// Average cache miss ratio: transformed vertices per triangle, 0.5 ~ 3.
+		[[nodiscard]] auto acmr() const -> float { return faces ? float(misses) / faces : 0.f; }
+
+		/// Average transform to vertex ratio: 1 is optimal.
+		[[nodiscard]] auto atvr() const -> float {
+			return vertices ? float(misses) / vertices : 0.f;
+		}
+
+		auto operator+=(const VertexCacheStats& another) -> VertexCacheStats& {
+			misses	 += another.misses;
+			faces	 += another.faces;
+			vertices += another.vertices;
+			return *this;
+		}
+	};
+
+	namespace details::mesh_optimizer {
+		/// Cache size assumed while scoring. Larger than real hardware on purpose, see Forsyth.
+		inline constexpr uint32_t scoring_cache_size = 32;
+
+		/// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation".
+		inline auto vertex_score(int32_t cache_position, uint32_t live_triangles) -> float {
+			if (live_triangles == 0)
+				return -1.f;
+
+			float score = 0.f;
+			if (cache_position >= 3)
+				score = std::pow(
+					1.f - float(cache_position - 3) / (scoring_cache_size - 3),
+					1.5f
+				);
+			else if (cache_position >= 0)
+				score = .75f;  // the last triangle's vertices, don't favor reusing them at once
+			return score + 2.f / std::sqrt(float(live_triangles));
+		}
+
+		/// Replays `indices` through a FIFO cache; returns the miss count.
+		class FifoCache {
+		public:
+			FifoCache(size_t vertex_count, uint32_t size) :
+				_timestamps(vertex_count, 0), _size(size), _time(size + 1) {}
+
+			auto access(uint32_t vertex) -> uint32_t {
+				if (_time - _timestamps[vertex] <= _size)
+					return 0;
+				_timestamps[vertex] = _time++;
+				return 1;
+			}
+
+			void reset() { _time += _size + 1; }
+
+		private:
+			std::vector<uint32_t> _timestamps;
+			uint32_t			  _size;
+			uint32_t			  _time;
+		};
+	}  // namespace details::mesh_optimizer
+
+	[[nodiscard]] inline auto analyze_vertex_cache(
+		std::span<const uint32_t> indices, size_t vertex_count, uint32_t cache_size = 16
+	) -> VertexCacheStats {
+		details::mesh_optimizer::FifoCache cache { vertex_count, cache_size };
+		std::vector<bool>				   referenced(vertex_count);
+
+		VertexCacheStats				   stats { .faces = indices.size() / 3 };
+		for (const auto index : indices) {
+			stats.misses += cache.access(index);
+			if (!referenced[index]) {
+				referenced[index] = true;
+				++stats.vertices;
+			}
+		}
+		return stats;
+	}
+
+	/// Reorders triangles in place so consecutive ones share as many vertices as possible.
+	inline void optimize_vertex_cache(std::span<uint32_t> indices, size_t vertex_count) {
+		using namespace details::mesh_optimizer;
+
+		const size_t face_count = indices.size() / 3;
+		if (face_count == 0)
+			return;
+
+		// Triangles adjacent to each vertex; the first `live[v]` entries are not emitted yet.
+		std::vector<uint32_t> live(vertex_count, 0);
+		for (const auto index : indices)
+			++live[index];
+
+		std::vector<uint32_t> offsets(vertex_count + 1, 0);
+		std::inclusive_scan(live.begin(), live.end(), offsets.begin() + 1);
+
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+			for (size_t face = 0; face < face_count; ++face)
+				for (size_t k = 0; k < 3; ++k)
+					adjacency[cursor[indices[face * 3 + k]]++] = static_cast<uint32_t>(face);
+		}
+
+		std::vector<int32_t> cache_positions(vertex_count, -1);
+		std::vector<float>	 vertex_scores(vertex_count);
+		for (size_t v = 0; v < vertex_count; ++v)
+			vertex_scores[v] = vertex_score(-1, live[v]);
+
+		const auto triangle_score = [&](size_t face) {
+			return vertex_scores[indices[face * 3 + 0]] + vertex_scores[indices[face * 3 + 1]]
+				 + vertex_scores[indices[face * 3 + 2]];
+		};
+
+		std::vector<float> face_scores(face_count);
+		for (size_t face = 0; face < face_count; ++face)
+			face_scores[face] = triangle_score(face);
+
+		std::vector<bool>	  emitted(face_count, false);
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+
+		std::vector<uint32_t> cache, next_cache;
+		cache.reserve(scoring_cache_size + 3);
+		next_cache.reserve(scoring_cache_size + 3);
+
+		auto   best	  = std::ranges::max_element(face_scores) - face_scores.begin();
+		size_t cursor = 0;
+		for (size_t count = 0; count < face_count; ++count) {
+			if (best < 0) {
+				// Nothing adjacent to the cache is left: restart from the next unemitted triangle.
+				while (emitted[cursor])
+					++cursor;
+				best = static_cast<decltype(best)>(cursor);
+			}
+
+			const auto face = static_cast<size_t>(best);
+			const auto tri	= std::array {
+				 indices[face * 3 + 0],
+				 indices[face * 3 + 1],
+				 indices[face * 3 + 2],
+			};
+			emitted[face] = true;
+			result.insert(result.end(), tri.begin(), tri.end());
+
+			for (const auto v : tri) {
+				const auto begin = adjacency.begin() + offsets[v];
+				const auto end	 = begin + live[v];
+				std::iter_swap(std::find(begin, end, static_cast<uint32_t>(face)), end - 1);
+				--live[v];
+			}
+
+			// Move the triangle's vertices to the front of the LRU cache.
+			next_cache.clear();
+			for (const auto v : tri)
+				if (std::ranges::find(next_cache, v) == next_cache.end())
+					next_cache.push_back(v);
+			for (const auto v : cache)
+				if (std::ranges::find(tri, v) == tri.end())
+					next_cache.push_back(v);
+
+			for (size_t i = 0; i < next_cache.size(); ++i) {
+				const auto v		= next_cache[i];
+				cache_positions[v]	= i < scoring_cache_size ? static_cast<int32_t>(i) : -1;
+				vertex_scores[v]	= vertex_score(cache_positions[v], live[v]);
+			}
+
+			best			 = -1;
+			float best_score = -1.f;
+			for (const auto v : next_cache)
+				for (uint32_t i = 0; i < live[v]; ++i) {
+					const auto adjacent	  = adjacency[offsets[v] + i];
+					face_scores[adjacent] = triangle_score(adjacent);
+					if (face_scores[adjacent] > best_score) {
+						best_score = face_scores[adjacent];
+						best	   = adjacent;
+					}
+				}
+
+			if (next_cache.size() > scoring_cache_size)
+				next_cache.resize(scoring_cache_size);
+			std::swap(cache, next_cache);
+		}
+
+		std::ranges::copy(result, indices.begin());
+	}
+
+	/// Reorders clusters of cache-optimized triangles front to back, as seen from outside the
+	/// mesh. Cluster boundaries are chosen so the ACMR grows by at most `threshold`.
+	///
+	/// Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+	inline void optimize_overdraw(
+		std::span<uint32_t> indices, std::span<const glm::vec3> positions, float threshold = 1.05f,
+		uint32_t cache_size = 16
+	) {
+		using namespace details::mesh_optimizer;
+
+		const size_t face_count = indices.size() / 3;
+		if (face_count < 2)
+			return;
+
+		FifoCache  cache { positions.size(), cache_size };
+		const auto misses_of = [&](size_t face) {
+			return cache.access(indices[face * 3 + 0]) + cache.access(indices[face * 3 + 1])
+				 + cache.access(indices[face * 3 + 2]);
+		};
+
+		// Hard boundaries: the cache optimizer restarted, every vertex of the triangle missed.
+		std::vector<size_t> hard;
+		for (size_t face = 0; face < face_count; ++face)
+			if (misses_of(face) == 3 || face == 0)
+				hard.push_back(face);
+		hard.push_back(face_count);
+
+		// Soft boundaries: split hard clusters wherever the running ACMR is already good enough.
+		std::vector<size_t> clusters;
+		for (size_t i = 0; i + 1 < hard.size(); ++i) {
+			const auto begin = hard[i], end = hard[i + 1];
+
+			cache.reset();
+			size_t cluster_misses = 0;
+			for (size_t face = begin; face < end; ++face)
+				cluster_misses += misses_of(face);
+			const float limit = threshold * float(cluster_misses) / float(end - begin);
+
+			clusters.push_back(begin);
+			cache.reset();
+			size_t misses = 0, faces = 0;
+			for (size_t face = begin; face < end; ++face) {
+				misses += misses_of(face);
+				faces  += 1;
+				if (face + 1 < end && float(misses) / float(faces) <= limit) {
+					clusters.push_back(face + 1);
+					cache.reset();
+					misses = faces = 0;
+				}
+			}
+		}
+		clusters.push_back(face_count);
+
+		glm::vec3 mesh_centroid { 0.f };
+		for (const auto index : indices)
+			mesh_centroid += positions[index];
+		mesh_centroid /= float(indices.size());
+
+		std::vector<float> sort_keys(clusters.size() - 1, 0.f);
+		for (size_t i = 0; i + 1 < clusters.size(); ++i) {
+			glm::vec3 centroid { 0.f }, normal { 0.f };
+			float	  area = 0.f;
+			for (size_t face = clusters[i]; face < clusters[i + 1]; ++face) {
+				const auto& p0			= positions[indices[face * 3 + 0]];
+				const auto& p1			= positions[indices[face * 3 + 1]];
+				const auto& p2			= positions[indices[face * 3 + 2]];
+				const auto	face_normal = glm::cross(p1 - p0, p2 - p0);
+				const auto	face_area	= glm::length(face_normal);
+
+				centroid += (p0 + p1 + p2) * (face_area / 3.f);
+				normal	 += face_normal;
+				area	 += face_area;
+			}
+			if (area > 0.f)
+				centroid /= area;
+			const auto normal_length = glm::length(normal);
+			if (normal_length > 0.f)
+				sort_keys[i] = glm::dot(centroid - mesh_centroid, normal / normal_length);
+		}
+
+		std::vector<size_t> order(sort_keys.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::ranges::stable_sort(order, std::greater {}, [&](size_t i) { return sort_keys[i]; });
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (const auto i : order)
+			result.insert(
+				result.end(),
+				indices.begin() + clusters[i] * 3,
+				indices.begin() + clusters[i + 1] * 3
+			);
+		std::ranges::copy(result, indices.begin());
+	}
+
+	/// Renumbers vertices in order of first use and drops unreferenced ones. Returns the old
+	/// index of every new vertex, for attribute streams that have to follow.
+	[[nodiscard]] inline auto remap_vertex_fetch(std::span<uint32_t> indices, size_t vertex_count)
+		-> std::vector<uint32_t> {
+		constexpr auto		  unused = ~uint32_t { 0 };
+		std::vector<uint32_t> remap(vertex_count, unused);
+		std::vector<uint32_t> order;
+		order.reserve(vertex_count);
+
+		for (auto& index : indices) {
+			if (remap[index] == unused) {
+				remap[index] = static_cast<uint32_t>(order.size());
+				order.push_back(index);
+			}
+			index = remap[index];
+		}
+		return order;
+	}
+
+	template<typename VerticeT>
+	[[nodiscard]] inline auto optimize_vertex_fetch(
+		std::span<uint32_t> indices, std::span<const VerticeT> vertices
+	) -> std::vector<VerticeT> {
+		const auto			  order = remap_vertex_fetch(indices, vertices.size());
+		std::vector<VerticeT> result;
+		result.reserve(order.size());
+		for (const auto index : order)
+			result.push_back(vertices[index]);
+		return result;
+	}
+}  // namespace dvdbchar
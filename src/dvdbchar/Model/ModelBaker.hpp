@@ -0,0 +1,868 @@
+#pragma once
+
+#include "dvdbchar/Model/BakedModel.hpp"
+#include "dvdbchar/Model/ImageDecoder.hpp"
+#include "dvdbchar/Model/MeshOptimizer.hpp"
+#include "dvdbchar/Utils.hpp"
+
+#include <fastgltf/core.hpp>
+#include <fastgltf/tools.hpp>
+#include <fastgltf/types.hpp>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+namespace dvdbchar {
+	namespace details::model_baker {
+		inline auto srgb_to_linear(uint8_t v) -> float {
+			static const auto table = []() {
+				std::array<float, 256> table;
+				for (size_t i = 0; i < table.size(); ++i) {
+					const float c = i / 255.f;
+					table[i] = c <= .04045f ? c / 12.92f : std::pow((c + .055f) / 1.055f, 2.4f);
+				}
+				return table;
+			}();
+			return table[v];
+		}
+
+		inline auto linear_to_srgb(float v) -> uint8_t {
+			static const auto table = []() {
+				std::array<uint8_t, 4096> table;
+				for (size_t i = 0; i < table.size(); ++i) {
+					const float c = i / float(table.size() - 1);
+					const float s =
+						c <= .0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.f / 2.4f) - .055f;
+					table[i] = static_cast<uint8_t>(std::lround(s * 255.f));
+				}
+				return table;
+			}();
+			return table[static_cast<size_t>(std::clamp(v, 0.f, 1.f) * (table.size() - 1) + .5f)];
+		}
+
+		/// 2x2 box filter in linear space; alpha is averaged as is.
+		inline void downsample_srgb(
+			const std::byte* src, uint32_t width, uint32_t height, std::byte* dst
+		) {
+			const auto dst_width  = std::max(1u, width / 2);
+			const auto dst_height = std::max(1u, height / 2);
+			const auto texel	  = [&](uint32_t x, uint32_t y, uint32_t c) {
+				 return std::to_integer<uint8_t>(src[(size_t { y } * width + x) * 4 + c]);
+			};
+
+			for (uint32_t y = 0; y < dst_height; ++y) {
+				const uint32_t y0 = std::min(y * 2, height - 1);
+				const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+				for (uint32_t x = 0; x < dst_width; ++x) {
+					const uint32_t x0  = std::min(x * 2, width - 1);
+					const uint32_t x1  = std::min(x * 2 + 1, width - 1);
+					auto*		   out = dst + (size_t { y } * dst_width + x) * 4;
+					for (uint32_t c = 0; c < 3; ++c)
+						out[c] = std::byte { linear_to_srgb(
+							(srgb_to_linear(texel(x0, y0, c)) + srgb_to_linear(texel(x1, y0, c))
+							 + srgb_to_linear(texel(x0, y1, c)) + srgb_to_linear(texel(x1, y1, c)))
+							* .25f
+						) };
+					out[3] = std::byte { static_cast<uint8_t>(
+						(texel(x0, y0, 3) + texel(x1, y0, 3) + texel(x0, y1, 3) + texel(x1, y1, 3)
+						 + 2)
+						/ 4
+					) };
+				}
+			}
+		}
+
+		[[nodiscard]] inline auto mip_chain_size(
+			baked::ImageFormat format, uint32_t width, uint32_t height
+		) -> size_t {
+			size_t size = 0;
+			for (uint32_t i = 0; i < baked::mip_count(width, height); ++i)
+				size += baked::level_size(
+					format,
+					baked::mip_extent(width, i),
+					baked::mip_extent(height, i)
+				);
+			return size;
+		}
+
+		/// BC7 needs whole blocks at level 0; smaller levels are padded by the format itself.
+		[[nodiscard]] inline auto image_format(const DecodedImage& image) -> baked::ImageFormat {
+			return image.width % 4 == 0 && image.height % 4 == 0 ? baked::ImageFormat::bc7
+																 : baked::ImageFormat::rgba8;
+		}
+
+		/// Writes all RGBA8 mip levels of `image` into `chain`, tightly packed from level 0 down
+		/// to 1x1.
+		inline void build_mip_chain(const DecodedImage& image, std::span<std::byte> chain) {
+			const auto levels = baked::mip_count(image.width, image.height);
+			std::memcpy(chain.data(), image.pixels.get(), image.byte_size());
+
+			size_t offset = 0;
+			for (uint32_t i = 1; i < levels; ++i) {
+				const auto width  = baked::mip_extent(image.width, i - 1);
+				const auto height = baked::mip_extent(image.height, i - 1);
+				const auto next	  = offset + size_t { width } * height * 4;
+				downsample_srgb(chain.data() + offset, width, height, chain.data() + next);
+				offset = next;
+			}
+		}
+
+		/// Builds the mip chain of `image` and stores it into `out` in `format`.
+		inline void bake_image(
+			const DecodedImage& image, baked::ImageFormat format, std::span<std::byte> out
+		) {
+			if (format == baked::ImageFormat::rgba8) {
+				build_mip_chain(image, out);
+				return;
+			}
+
+			std::vector<std::byte> chain(
+				mip_chain_size(baked::ImageFormat::rgba8, image.width, image.height)
+			);
+			build_mip_chain(image, chain);
+
+			size_t src = 0, dst = 0;
+			for (uint32_t i = 0; i < baked::mip_count(image.width, image.height); ++i) {
+				const auto width  = baked::mip_extent(image.width, i);
+				const auto height = baked::mip_extent(image.height, i);
+				const auto size	  = baked::level_size(format, width, height);
+				Render::compress_bc7(
+					std::span { chain }.subspan(src),
+					width,
+					height,
+					out.subspan(dst, size)
+				);
+				src += size_t { width } * height * 4;
+				dst += size;
+			}
+		}
+
+		/// Normalizes `weights` and quantizes them to unorm16, keeping the sum exactly 65535.
+		inline auto encode_weights(std::array<float, 4> weights) -> std::array<uint16_t, 4> {
+			const float sum = weights[0] + weights[1] + weights[2] + weights[3];
+			if (sum <= 0.f)
+				return { 65535, 0, 0, 0 };
+
+			std::array<uint16_t, 4> out;
+			uint32_t				total = 0;
+			for (size_t i = 0; i < 4; ++i) {
+				out[i]	= static_cast<uint16_t>(std::lround(weights[i] / sum * 65535.f));
+				total  += out[i];
+			}
+			// Rounding error goes to the heaviest influence.
+			auto& heaviest = *std::ranges::max_element(out);
+			heaviest	   = static_cast<uint16_t>(heaviest + 65535 - total);
+			return out;
+		}
+
+		/// Orders nodes depth first from the scene roots, so every parent precedes its children.
+		/// Returns the baked index of every glTF node.
+		inline auto append_nodes(BakedModel::Writer& writer, const fastgltf::Asset& asset)
+			-> std::vector<uint32_t> {
+			std::vector<int32_t> parents(asset.nodes.size(), -1);
+			for (const auto& [i, node] : ranges::views::enumerate(asset.nodes))
+				for (const auto child : node.children)
+					parents[child] = static_cast<int32_t>(i);
+
+			std::vector<uint32_t> remap(asset.nodes.size());
+			std::vector<size_t>	  stack;
+			for (size_t root = 0; root < asset.nodes.size(); ++root) {
+				if (parents[root] >= 0)
+					continue;
+				stack.push_back(root);
+				while (!stack.empty()) {
+					const auto index = stack.back();
+					stack.pop_back();
+
+					const auto& node = asset.nodes[index];
+					remap[index]	 = static_cast<uint32_t>(writer.nodes.size());
+
+					fastgltf::math::fvec3 translation, scale;
+					fastgltf::math::fquat rotation;
+					std::visit(
+						fastgltf::visitor {
+							[&](const fastgltf::TRS& trs) {
+								translation = trs.translation;
+								rotation	= trs.rotation;
+								scale		= trs.scale;
+							},
+							[&](const fastgltf::math::fmat4x4& matrix) {
+								fastgltf::math::decomposeTransformMatrix(
+									matrix,
+									scale,
+									rotation,
+									translation
+								);
+							},
+						},
+						node.transform
+					);
+					writer.nodes.push_back({
+						.translation = { translation.x(), translation.y(), translation.z() },
+						.parent		 = parents[index] >= 0
+										 ? static_cast<int32_t>(remap[parents[index]])
+										 : -1,
+						.rotation	 = { rotation.w(), rotation.x(), rotation.y(), rotation.z() },
+						.scale		 = { scale.x(), scale.y(), scale.z() },
+					});
+
+					for (const auto child : node.children | ranges::views::reverse)
+						stack.push_back(child);
+				}
+			}
+			return remap;
+		}
+
+		inline void append_skins(
+			BakedModel::Writer& writer, const fastgltf::Asset& asset,
+			std::span<const uint32_t> node_remap
+		) {
+			for (const auto& skin : asset.skins) {
+				const auto first_joint = static_cast<uint32_t>(writer.joints.size());
+				for (const auto joint : skin.joints)
+					writer.joints.push_back({
+						.inverse_bind = glm::mat4 { 1.f },
+						.node		  = node_remap[joint],
+					});
+
+				if (skin.inverseBindMatrices.has_value())
+					fastgltf::iterateAccessorWithIndex<fastgltf::math::fmat4x4>(
+						asset,
+						asset.accessors[*skin.inverseBindMatrices],
+						[&](const fastgltf::math::fmat4x4& m, size_t idx) {
+							// Both are column major.
+							std::memcpy(
+								&writer.joints[first_joint + idx].inverse_bind,
+								m.data(),
+								sizeof(glm::mat4)
+							);
+						}
+					);
+
+				writer.skins.push_back({
+					.first_joint = first_joint,
+					.joint_count = static_cast<uint32_t>(skin.joints.size()),
+				});
+			}
+		}
+
+		inline auto vec3_of(const nlohmann::json& json, glm::vec3 fallback) -> glm::vec3 {
+			if (!json.is_array() || json.size() != 3)
+				return fallback;
+			return { json[0].get<float>(), json[1].get<float>(), json[2].get<float>() };
+		}
+
+		/// Reads the `VRMC_springBone` extension of `document`, if any. Collider groups are
+		/// flattened into one collider list per spring.
+		inline void append_springs(
+			BakedModel::Writer& writer, const nlohmann::json& document,
+			std::span<const uint32_t> node_remap
+		) {
+			const auto extensions = document.find("extensions");
+			if (extensions == document.end() || !extensions->contains("VRMC_springBone"))
+				return;
+			const auto& spring_bone = extensions->at("VRMC_springBone");
+			const auto	empty		= nlohmann::json::array();
+
+			for (const auto& collider : spring_bone.value("colliders", empty)) {
+				baked::Collider out { .node = node_remap[collider.at("node").get<size_t>()] };
+				const auto&		shape = collider.at("shape");
+				if (const auto sphere = shape.find("sphere"); sphere != shape.end()) {
+					out.offset = vec3_of(sphere->value("offset", empty), glm::vec3 { 0.f });
+					out.radius = sphere->value("radius", 0.f);
+					out.tail   = out.offset;
+				} else if (const auto capsule = shape.find("capsule"); capsule != shape.end()) {
+					out.offset = vec3_of(capsule->value("offset", empty), glm::vec3 { 0.f });
+					out.radius = capsule->value("radius", 0.f);
+					out.tail   = vec3_of(capsule->value("tail", empty), glm::vec3 { 0.f });
+				}
+				writer.colliders.push_back(out);
+			}
+
+			const auto groups = spring_bone.value("colliderGroups", empty);
+			for (const auto& spring : spring_bone.value("springs", empty)) {
+				baked::Spring out {
+					.first_joint	= static_cast<uint32_t>(writer.spring_joints.size()),
+					.first_collider = static_cast<uint32_t>(writer.spring_colliders.size()),
+				};
+				for (const auto& joint : spring.value("joints", empty))
+					writer.spring_joints.push_back({
+						.node		= node_remap[joint.at("node").get<size_t>()],
+						.hit_radius = joint.value("hitRadius", 0.f),
+						.stiffness	= joint.value("stiffness", 1.f),
+						.drag_force = joint.value("dragForce", .5f),
+						.gravity	= vec3_of(joint.value("gravityDir", empty), { 0.f, -1.f, 0.f })
+								 * joint.value("gravityPower", 0.f),
+					});
+				for (const auto& group : spring.value("colliderGroups", empty)) {
+					const auto& members = groups.at(group.get<size_t>());
+					for (const auto& collider : members.value("colliders", empty))
+						writer.spring_colliders.push_back(collider.get<uint32_t>());
+				}
+
+				out.joint_count =
+					static_cast<uint32_t>(writer.spring_joints.size()) - out.first_joint;
+				out.collider_count =
+					static_cast<uint32_t>(writer.spring_colliders.size()) - out.first_collider;
+				writer.springs.push_back(out);
+			}
+		}
+
+		/// Unit vector of a constraint axis name: `X` for roll, `PositiveX` or `NegativeX` for aim.
+		inline auto constraint_axis(std::string_view name) -> glm::vec3 {
+			const float sign = name.starts_with("Negative") ? -1.f : 1.f;
+			switch (name.empty() ? 'X' : name.back()) {
+			case 'Y': return { 0.f, sign, 0.f };
+			case 'Z': return { 0.f, 0.f, sign };
+			default: return { sign, 0.f, 0.f };
+			}
+		}
+
+		/// Constraints `constraint` reads the result of: the one driving its source and, since
+		/// aim constraints look at world positions, those on the ancestors of both nodes.
+		template<typename F>
+		inline void for_each_dependency(
+			const baked::Constraint& constraint, std::span<const baked::Node> nodes,
+			std::span<const int32_t> by_node, F&& f
+		) {
+			if (constraint.kind != baked::ConstraintKind::aim) {
+				if (by_node[constraint.source] >= 0)
+					f(static_cast<size_t>(by_node[constraint.source]));
+				return;
+			}
+			for (int32_t n = static_cast<int32_t>(constraint.source); n >= 0; n = nodes[n].parent)
+				if (by_node[n] >= 0)
+					f(static_cast<size_t>(by_node[n]));
+			for (int32_t n = nodes[constraint.node].parent; n >= 0; n = nodes[n].parent)
+				if (by_node[n] >= 0)
+					f(static_cast<size_t>(by_node[n]));
+		}
+
+		/// Reads the `VRMC_node_constraint` extension of every node in `document` and stores the
+		/// constraints sorted so that evaluating them in order is one linear pass. Circular
+		/// constraints are invalid and dropped.
+		inline void append_constraints(
+			BakedModel::Writer& writer, const nlohmann::json& document,
+			std::span<const uint32_t> node_remap
+		) {
+			std::vector<baked::Constraint> constraints;
+			const auto					   empty = nlohmann::json::array();
+			const auto					   nodes = document.value("nodes", empty);
+			for (const auto& [i, node] : ranges::views::enumerate(nodes)) {
+				const auto extensions = node.find("extensions");
+				if (extensions == node.end() || !extensions->contains("VRMC_node_constraint"))
+					continue;
+				const auto& constraint = extensions->at("VRMC_node_constraint").at("constraint");
+
+				baked::Constraint out { .node = node_remap[i] };
+				const nlohmann::json* params;
+				if (const auto roll = constraint.find("roll"); roll != constraint.end()) {
+					out.kind = baked::ConstraintKind::roll;
+					out.axis = constraint_axis(roll->value("rollAxis", std::string { "X" }));
+					params	 = &*roll;
+				} else if (const auto aim = constraint.find("aim"); aim != constraint.end()) {
+					out.kind = baked::ConstraintKind::aim;
+					out.axis = constraint_axis(aim->value("aimAxis", std::string { "PositiveX" }));
+					params	 = &*aim;
+				} else if (const auto rotation = constraint.find("rotation");
+						   rotation != constraint.end()) {
+					out.kind = baked::ConstraintKind::rotation;
+					params	 = &*rotation;
+				} else
+					continue;
+				const auto source = params->find("source");
+				if (source == params->end() || !source->is_number_unsigned()
+					|| source->get<size_t>() >= nodes.size()) {
+					spdlog::warn("dropped constraint on node {} without a valid source", out.node);
+					continue;
+				}
+				out.source = node_remap[source->get<size_t>()];
+				out.weight = params->value("weight", 1.f);
+				constraints.push_back(out);
+			}
+
+			std::vector<int32_t> by_node(writer.nodes.size(), -1);
+			for (const auto& [i, constraint] : ranges::views::enumerate(constraints))
+				by_node[constraint.node] = static_cast<int32_t>(i);
+
+			// Depth first over dependencies, emitting each constraint after all it depends on.
+			enum class State : uint8_t { unvisited, visiting, done };
+			std::vector<State> states(constraints.size(), State::unvisited);
+			const auto		   visit = [&](auto& self, size_t i) -> bool {
+				  if (states[i] != State::unvisited)
+					  return states[i] == State::done;
+				  states[i] = State::visiting;
+				  bool valid = true;
+				  for_each_dependency(constraints[i], writer.nodes, by_node, [&](size_t dep) {
+					  valid = valid && self(self, dep);
+				  });
+				  states[i] = State::done;
+				  if (valid)
+					  writer.constraints.push_back(constraints[i]);
+				  else
+					  spdlog::warn("dropped circular constraint on node {}", constraints[i].node);
+				  return valid;
+			};
+			for (size_t i = 0; i < constraints.size(); ++i)
+				visit(visit, i);
+		}
+
+		/// Morph deltas with every component below this are treated as zero and not stored.
+		inline constexpr float morph_epsilon = 1e-6f;
+
+		inline auto is_negligible(const baked::MorphDelta& delta) -> bool {
+			return glm::all(glm::lessThan(glm::abs(delta.position), glm::vec3 { morph_epsilon }))
+				&& glm::all(glm::lessThan(glm::abs(delta.normal), glm::vec3 { morph_epsilon }));
+		}
+
+		struct PrimitiveReport {
+			VertexCacheStats before;
+			VertexCacheStats after;
+			bool			 skinned = false;  // has `JOINTS_0` and `WEIGHTS_0`
+		};
+
+		/// Appends `primitive` with its triangles reordered for the vertex cache and overdraw,
+		/// and its vertices renumbered in fetch order. The non-zero deltas of its morph targets
+		/// are appended to `morphs`, one list per target of the mesh.
+		inline auto append_primitive(
+			BakedModel::Writer& writer, const fastgltf::Asset& asset,
+			const fastgltf::Primitive& primitive, uint32_t fallback_material,
+			std::span<std::vector<baked::MorphDelta>> morphs
+		) -> PrimitiveReport {
+			baked::Primitive out {
+				.first_vertex = static_cast<uint32_t>(writer.vertices.size()),
+				.material =
+					static_cast<uint32_t>(primitive.materialIndex.value_or(fallback_material)),
+			};
+
+			std::vector<Render::Vertice> vertices;
+			{  // Vertices
+				auto it = primitive.findAttribute("POSITION");
+				if (it == primitive.attributes.end()) [[unlikely]]
+					panic("wtf this gltf has no attribute `POSITION`?");
+
+				auto& accessor = asset.accessors[it->accessorIndex];
+				vertices.resize(accessor.count);
+
+				fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
+					asset,
+					accessor,
+					[&](fastgltf::math::fvec3 v, size_t idx) {
+						vertices[idx].pos = { v.x(), v.y(), v.z() };
+					}
+				);
+
+				if (auto it = primitive.findAttribute("NORMAL"); it != primitive.attributes.end())
+					fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
+						asset,
+						asset.accessors[it->accessorIndex],
+						[&](fastgltf::math::fvec3 v, size_t idx) {
+							vertices[idx].normal =
+								Render::Vertice::Normal::encode({ v.x(), v.y(), v.z() });
+						}
+					);
+
+				if (auto it = primitive.findAttribute("TEXCOORD_0");
+					it != primitive.attributes.end()) {
+					fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec2>(
+						asset,
+						asset.accessors[it->accessorIndex],
+						[&](fastgltf::math::fvec2 v, size_t idx) {
+							vertices[idx].uv = Render::Vertice::Uv::encode({ v.x(), v.y() });
+						}
+					);
+				} else [[unlikely]] {
+					panic("wtf this gltf has no attribute `TEXCOORD_0`?");
+				}
+			}
+
+			PrimitiveReport				   report;
+			std::vector<baked::SkinVertex> skin(vertices.size());
+			{  // Skinning, optional
+				auto joints	 = primitive.findAttribute("JOINTS_0");
+				auto weights = primitive.findAttribute("WEIGHTS_0");
+				report.skinned =
+					joints != primitive.attributes.end() && weights != primitive.attributes.end();
+				if (report.skinned) {
+					fastgltf::iterateAccessorWithIndex<fastgltf::math::u16vec4>(
+						asset,
+						asset.accessors[joints->accessorIndex],
+						[&](fastgltf::math::u16vec4 v, size_t idx) {
+							skin[idx].joints = { v.x(), v.y(), v.z(), v.w() };
+						}
+					);
+					fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec4>(
+						asset,
+						asset.accessors[weights->accessorIndex],
+						[&](fastgltf::math::fvec4 v, size_t idx) {
+							skin[idx].weights = encode_weights({ v.x(), v.y(), v.z(), v.w() });
+						}
+					);
+				}
+			}
+
+			std::vector<uint32_t> indices;
+			{  // Indices
+				if (!primitive.indicesAccessor.has_value()) [[unlikely]]
+					panic("wtf this gltf has no indice accessor?");
+
+				auto& accessor = asset.accessors[*primitive.indicesAccessor];
+				switch (accessor.componentType) {
+					case fastgltf::ComponentType::UnsignedByte:
+					case fastgltf::ComponentType::UnsignedShort: out.index_size = 2; break;
+					case fastgltf::ComponentType::UnsignedInt: out.index_size = 4; break;
+					default: panic("unexpected index type!"); break;
+				}
+				indices.resize(accessor.count);
+				fastgltf::copyFromAccessor<std::uint32_t>(asset, accessor, indices.data());
+			}
+
+			std::vector<uint32_t> order;
+			const auto			  source_vertex_count = vertices.size();
+			{  // Optimization
+				report.before = analyze_vertex_cache(indices, vertices.size());
+
+				const auto positions = vertices
+									 | ranges::views::transform(&Render::Vertice::pos)
+									 | ranges::to<std::vector>();
+				optimize_vertex_cache(indices, vertices.size());
+				optimize_overdraw(indices, positions);
+
+				order			   = remap_vertex_fetch(indices, vertices.size());
+				const auto permute = [&](const auto& stream) {
+					return order | ranges::views::transform([&](uint32_t i) { return stream[i]; })
+						 | ranges::to<std::vector>();
+				};
+				vertices = permute(vertices);
+				skin	 = permute(skin);
+
+				report.after = analyze_vertex_cache(indices, vertices.size());
+			}
+
+			{  // Morph targets, optional; read densely, kept sparse in fetch order
+				std::vector<baked::MorphDelta> dense;
+				for (size_t target = 0; target < std::min(morphs.size(), primitive.targets.size());
+					 ++target) {
+					dense.assign(source_vertex_count, {});
+					const auto read = [&](std::string_view name, auto field) {
+						auto it = primitive.findTargetAttribute(target, name);
+						if (it == primitive.targets[target].end())
+							return;
+						fastgltf::iterateAccessorWithIndex<fastgltf::math::fvec3>(
+							asset,
+							asset.accessors[it->accessorIndex],
+							[&](fastgltf::math::fvec3 v, size_t idx) {
+								dense[idx].*field = glm::vec3 { v.x(), v.y(), v.z() };
+							}
+						);
+					};
+					read("POSITION", &baked::MorphDelta::position);
+					read("NORMAL", &baked::MorphDelta::normal);
+
+					for (const auto& [i, source] : ranges::views::enumerate(order)) {
+						auto delta = dense[source];
+						if (is_negligible(delta))
+							continue;
+						delta.vertex = out.first_vertex + static_cast<uint32_t>(i);
+						morphs[target].push_back(delta);
+					}
+				}
+			}
+
+			out.vertex_count = static_cast<uint32_t>(vertices.size());
+			writer.vertices.insert(writer.vertices.end(), vertices.begin(), vertices.end());
+			writer.skin_vertices.insert(writer.skin_vertices.end(), skin.begin(), skin.end());
+
+			// Indices are stored at their native width; 8-bit ones are widened for wgpu. Fetch
+			// remapping never grows the vertex count, so 16-bit indices still fit.
+			out.index_count	 = static_cast<uint32_t>(indices.size());
+			out.index_offset = writer.indices.size();
+			writer.indices.resize(baked::align_up(
+				writer.indices.size() + size_t { out.index_count } * out.index_size,
+				4
+			));
+
+			auto* dst = writer.indices.data() + out.index_offset;
+			if (out.index_size == 2)
+				std::ranges::transform(
+					indices,
+					reinterpret_cast<std::uint16_t*>(dst),
+					[](uint32_t index) { return static_cast<std::uint16_t>(index); }
+				);
+			else
+				std::memcpy(dst, indices.data(), indices.size() * sizeof(uint32_t));
+
+			writer.primitives.push_back(out);
+			return report;
+		}
+	}  // namespace details::model_baker
+
+	inline auto load_gltf(const std::filesystem::path& path) -> fastgltf::Asset {
+		constexpr auto parser_opt = fastgltf::Extensions::KHR_mesh_quantization
+								  | fastgltf::Extensions::KHR_texture_transform
+								  | fastgltf::Extensions::KHR_materials_variants;
+		constexpr auto asset_opt = fastgltf::Options::LoadExternalBuffers  //
+								 | fastgltf::Options::LoadExternalImages   //
+								 | fastgltf::Options::AllowDouble		   //
+								 | fastgltf::Options::GenerateMeshIndices; //
+
+		auto parser = fastgltf::Parser { parser_opt };
+		auto file	= fastgltf::MappedGltfFile::FromPath(path);
+		if (!file)
+			throw std::runtime_error {
+				std::format("Failed to read model file at `{}`.", path.string())
+			};
+
+		auto asset = parser.loadGltf(file.get(), path.parent_path(), asset_opt);
+		if (!asset)
+			throw std::runtime_error {
+				std::format("Failed to load model at `{}`: {}", path.string(), (int)asset.error())
+			};
+		return std::move(asset.get());
+	}
+
+	/// Raw JSON document of the .gltf/.glb/.vrm at `path`, for the VRM extensions fastgltf does
+	/// not parse.
+	inline auto load_gltf_json(const std::filesystem::path& path) -> nlohmann::json {
+		const auto file = MappedFile::open(path);
+		if (!file)
+			throw std::runtime_error {
+				std::format("Failed to read model file at `{}`.", path.string())
+			};
+
+		// GLB: 12-byte header, then the JSON chunk as length, type and data.
+		auto bytes = file->bytes();
+		if (bytes.size() >= 20 && std::memcmp(bytes.data(), "glTF", 4) == 0) {
+			uint32_t length;
+			std::memcpy(&length, bytes.data() + 12, sizeof(length));
+			bytes = bytes.subspan(20, std::min<size_t>(length, bytes.size() - 20));
+		}
+		const auto* begin = reinterpret_cast<const char*>(bytes.data());
+		return nlohmann::json::parse(begin, begin + bytes.size());
+	}
+
+	/// Converts a parsed glTF into pack layout: `Render::Vertice` vertices, cache-optimized
+	/// native-width indices and RGBA8 textures with full sRGB-correct mip chains.
+	inline auto bake_model(
+		const fastgltf::Asset& asset, const nlohmann::json& document, const baked::Source& source
+	) -> BakedModel {
+		using namespace details::model_baker;
+
+		const auto		   start = std::chrono::steady_clock::now();
+		BakedModel::Writer writer;
+
+		{  // Images, mip chains are built and block compressed in place in the pixel section
+			const auto images = decode_images(asset);
+
+			size_t pixel_size = 0;
+			for (const auto& image : images) {
+				const auto format = image_format(image);
+				const auto size	  = mip_chain_size(format, image.width, image.height);
+				writer.images.push_back({
+					.width		  = image.width,
+					.height		  = image.height,
+					.mip_count	  = baked::mip_count(image.width, image.height),
+					.format		  = format,
+					.pixel_offset = pixel_size,
+					.pixel_size	  = size,
+				});
+				pixel_size += size;
+			}
+			writer.pixels.resize(pixel_size);
+
+			if (!images.empty()) {
+				exec::static_thread_pool pool { static_cast<uint32_t>(std::min<size_t>(
+					std::max(1u, std::thread::hardware_concurrency()),
+					images.size()
+				)) };
+				stdexec::sync_wait(
+					stdexec::schedule(pool.get_scheduler())	 //
+					| stdexec::bulk(stdexec::par, images.size(), [&](size_t i) {
+						  const auto& image	 = writer.images[i];
+						  const auto  pixels = std::span { writer.pixels };
+						  bake_image(
+							  images[i],
+							  image.format,
+							  pixels.subspan(image.pixel_offset, image.pixel_size)
+						  );
+					  })
+				);
+			}
+		}
+
+		{  // Materials, plus a trailing fallback for primitives without one
+			for (const auto& material : asset.materials) {
+				baked::Material out;
+				if (material.pbrData.baseColorTexture.has_value()) {
+					auto& texture = asset.textures[material.pbrData.baseColorTexture->textureIndex];
+					if (!texture.imageIndex.has_value()) [[unlikely]]
+						panic("texture does not have imageIndex!");
+					if (*texture.imageIndex < writer.images.size())
+						out.albedo_image = static_cast<int32_t>(*texture.imageIndex);
+					else
+						spdlog::warn("material drops missing image {}", *texture.imageIndex);
+				}
+				writer.materials.push_back(out);
+			}
+			writer.materials.push_back({});
+		}
+
+		const auto node_remap = append_nodes(writer, asset);
+		append_skins(writer, asset, node_remap);
+		append_springs(writer, document, node_remap);
+		append_constraints(writer, document, node_remap);
+
+		{  // Geometry
+			const auto		fallback_material = static_cast<uint32_t>(writer.materials.size() - 1);
+			PrimitiveReport total;
+
+			// Deformable vertices of each mesh, split where primitives start or stop having skin
+			// attributes: vertices without any are left out of skinning, only ever morphed.
+			struct MeshRun {
+				baked::SkinnedRange range;
+				bool				skinned;
+			};
+			std::vector<std::vector<MeshRun>> mesh_runs;
+			for (const auto& mesh : asset.meshes) {
+				const auto first_vertex	   = static_cast<uint32_t>(writer.vertices.size());
+				const auto first_primitive = static_cast<uint32_t>(writer.primitives.size());
+				const auto target_count =
+					mesh.primitives.empty() ? 0 : mesh.primitives.front().targets.size();
+				std::vector<std::vector<baked::MorphDelta>> morphs(target_count);
+				auto&										runs = mesh_runs.emplace_back();
+				for (const auto& primitive : mesh.primitives) {
+					const auto primitive_vertex = static_cast<uint32_t>(writer.vertices.size());
+					const auto report =
+						append_primitive(writer, asset, primitive, fallback_material, morphs);
+					const auto vertex_count =
+						static_cast<uint32_t>(writer.vertices.size()) - primitive_vertex;
+					if (!runs.empty() && runs.back().skinned == report.skinned)
+						runs.back().range.vertex_count += vertex_count;
+					else
+						runs.push_back({
+							.range = {
+								.first_vertex  = primitive_vertex,
+								.vertex_count  = vertex_count,
+								.skin		   = baked::no_skin,
+								.morphed	   = target_count > 0,
+								.output_vertex = primitive_vertex,
+							},
+							.skinned = report.skinned,
+						});
+					spdlog::debug(
+						"primitive[{}] of `{}`: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+						writer.primitives.size() - 1,
+						mesh.name,
+						report.before.acmr(),
+						report.after.acmr(),
+						report.before.atvr(),
+						report.after.atvr()
+					);
+					total.before += report.before;
+					total.after	 += report.after;
+				}
+
+				writer.meshes.push_back({
+					.first_primitive = first_primitive,
+					.primitive_count =
+						static_cast<uint32_t>(writer.primitives.size()) - first_primitive,
+					.first_target = static_cast<uint32_t>(writer.morph_targets.size()),
+					.target_count = static_cast<uint32_t>(target_count),
+					.first_vertex = first_vertex,
+					.vertex_count = static_cast<uint32_t>(writer.vertices.size()) - first_vertex,
+				});
+				for (const auto& [target, deltas] : ranges::views::enumerate(morphs)) {
+					writer.morph_targets.push_back({
+						.first_delta	= static_cast<uint32_t>(writer.morph_deltas.size()),
+						.delta_count	= static_cast<uint32_t>(deltas.size()),
+						.default_weight = target < mesh.weights.size() ? mesh.weights[target] : 0.f,
+					});
+					writer.morph_deltas.insert(
+						writer.morph_deltas.end(),
+						deltas.begin(),
+						deltas.end()
+					);
+				}
+			}
+
+			// glTF skins belong to nodes, so every node pairing a mesh with a skin adds ranges.
+			// Morphed meshes without a skin still need them to be deformed. Deformed vertices are
+			// in model space, so nodes sharing mesh and skin share them as well; the first pairing
+			// of a mesh deforms it in place, any other one a copy past the vertex section.
+			std::map<std::pair<uint32_t, uint32_t>, uint32_t> shifts;  // by mesh and skin
+			std::vector<bool>								  in_place(writer.meshes.size());
+			auto copy_vertex = static_cast<uint32_t>(writer.vertices.size());
+			for (const auto& [i, node] : ranges::views::enumerate(asset.nodes)) {
+				if (!node.meshIndex.has_value())
+					continue;
+				const auto mesh = static_cast<uint32_t>(*node.meshIndex);
+				const auto skin = node.skinIndex.has_value()
+									? static_cast<uint32_t>(*node.skinIndex)
+									: baked::no_skin;
+
+				const auto [shift, added] = shifts.try_emplace({ mesh, skin }, 0u);
+				if (added) {
+					if (in_place[mesh]) {
+						shift->second  = copy_vertex - writer.meshes[mesh].first_vertex;
+						copy_vertex	  += writer.meshes[mesh].vertex_count;
+					}
+					in_place[mesh] = true;
+					for (auto [range, skinned] : mesh_runs[mesh]) {
+						if (skinned && skin != baked::no_skin)
+							range.skin = skin;
+						else if (!range.morphed)
+							continue;
+						range.output_vertex = range.first_vertex + shift->second;
+						writer.skinned_ranges.push_back(range);
+					}
+				}
+				writer.instances.push_back({
+					.node		  = node_remap[i],
+					.mesh		  = mesh,
+					.skin		  = skin,
+					.vertex_shift = shift->second,
+				});
+			}
+
+			spdlog::info(
+				"optimized {} triangles: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+				total.after.faces,
+				total.before.acmr(),
+				total.after.acmr(),
+				total.before.atvr(),
+				total.after.atvr()
+			);
+		}
+
+		const std::chrono::duration<double, std::milli> elapsed =
+			std::chrono::steady_clock::now() - start;
+		spdlog::info(
+			"baked {} primitives, {} materials, {} images, {} nodes, {} skins, {} morph targets "
+			"({} deltas), {} springs, {} constraints in {:.2f} ms",
+			writer.primitives.size(),
+			writer.materials.size(),
+			writer.images.size(),
+			writer.nodes.size(),
+			writer.skins.size(),
+			writer.morph_targets.size(),
+			writer.morph_deltas.size(),
+			writer.springs.size(),
+			writer.constraints.size(),
+			elapsed.count()
+		);
+
+		return std::move(writer).finish(source);
+	}
+}  // namespace dvdbchar
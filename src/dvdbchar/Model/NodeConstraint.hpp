@@ -0,0 +1,104 @@
+#pragma once
+
+#include "dvdbchar/Model/BakedModel.hpp"
+#include "dvdbchar/Model/SceneGraph.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace dvdbchar {
+	/// VRMC_node_constraint roll, aim and rotation constraints.
+	///
+	/// Constraints come out of the pack in dependency order with the rest rotations they need
+	/// resolved at load time, so evaluating them is one linear pass that overwrites the local
+	/// rotation of every constrained node.
+	class NodeConstraintSolver {
+	public:
+		NodeConstraintSolver() = default;
+
+		explicit NodeConstraintSolver(const BakedModel& baked) {
+			const auto nodes = baked.nodes();
+			for (const auto& constraint : baked.constraints())
+				_constraints.push_back({
+					.baked		 = constraint,
+					.rest		 = nodes[constraint.node].rotation,
+					.source_rest = nodes[constraint.source].rotation,
+				});
+		}
+
+	public:
+		[[nodiscard]] auto empty() const -> bool { return _constraints.empty(); }
+
+		/// Runs after animation and tracking wrote the pose of `scene`, before spring bones and
+		/// skinning read it. Leaves `scene` to be updated by the caller.
+		void update(SceneGraph& scene) const {
+			bool stale = true;	// world matrices lag behind the rotations written so far
+			for (const auto& constraint : _constraints) {
+				const bool aim = constraint.baked.kind == baked::ConstraintKind::aim;
+				if (aim && std::exchange(stale, false))
+					scene.update();
+				const auto& node	 = constraint.baked.node;
+				const auto	rotation = glm::slerp(
+					 constraint.rest,
+					 _evaluate(constraint, scene),
+					 constraint.baked.weight
+				 );
+				if (rotation == scene.local(node).rotation)
+					continue;  // keeps the subtree clean while the source holds still
+				scene.set_rotation(node, rotation);
+				stale = true;
+			}
+		}
+
+	private:
+		struct Constraint {
+			baked::Constraint baked;
+			glm::quat		  rest;
+			glm::quat		  source_rest;
+		};
+
+		/// Fully weighted local rotation of the constrained node.
+		[[nodiscard]] static auto _evaluate(const Constraint& constraint, const SceneGraph& scene)
+			-> glm::quat {
+			using details::scene_graph::rotation_between;
+
+			const auto& c	 = constraint.baked;
+			const auto& rest = constraint.rest;
+			if (c.kind == baked::ConstraintKind::aim) {
+				const auto world  = scene.world();
+				const auto parent = scene.parent(c.node);
+				const auto parent_rotation =
+					parent >= 0 ? glm::quat_cast(glm::mat3 {
+									  glm::normalize(glm::vec3 { world[parent][0] }),
+									  glm::normalize(glm::vec3 { world[parent][1] }),
+									  glm::normalize(glm::vec3 { world[parent][2] }),
+								  })
+								: glm::quat { 1.f, 0.f, 0.f, 0.f };
+				const auto from = parent_rotation * rest * c.axis;
+				const auto to	= glm::vec3 { world[c.source][3] - world[c.node][3] };
+				if (glm::dot(to, to) < 1e-12f)
+					return rest;
+				return glm::inverse(parent_rotation) * rotation_between(from, glm::normalize(to))
+					 * parent_rotation * rest;
+			}
+
+			const auto& source_rest = constraint.source_rest;
+			const auto	delta		= glm::inverse(source_rest) * scene.local(c.source).rotation;
+			if (c.kind == baked::ConstraintKind::rotation)
+				return rest * delta;
+
+			// Roll: bring the source's delta into the constrained node's space and keep only the
+			// twist around the roll axis.
+			const auto in_parent = source_rest * delta * glm::inverse(source_rest);
+			const auto in_node	 = glm::inverse(rest) * in_parent * rest;
+			const auto swing	 = rotation_between(c.axis, in_node * c.axis);
+			return rest * glm::inverse(swing) * in_node;
+		}
+
+	private:
+		std::vector<Constraint> _constraints;
+	};
+}  // namespace dvdbchar
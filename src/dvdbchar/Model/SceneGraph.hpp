@@ -0,0 +1,177 @@
+#pragma once
+
+#include "dvdbchar/Model/BakedModel.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dvdbchar {
+	namespace details::scene_graph {
+		/// Shortest rotation taking unit vector `from` onto unit vector `to`.
+		inline auto rotation_between(const glm::vec3& from, const glm::vec3& to) -> glm::quat {
+			const float w = 1.f + glm::dot(from, to);
+			if (w < 1e-6f)	// opposite, any perpendicular axis does
+				return glm::angleAxis(
+					glm::pi<float>(),
+					glm::normalize(
+						std::abs(from.x) > .9f ? glm::cross(from, glm::vec3 { 0.f, 1.f, 0.f })
+											   : glm::cross(from, glm::vec3 { 1.f, 0.f, 0.f })
+					)
+				);
+			return glm::normalize(glm::quat { w, glm::cross(from, to) });
+		}
+
+		/// Nodes `compose_locals()` works on at once, a multiple of every SIMD width.
+		inline constexpr size_t compose_block = 16;
+
+		/// Writes the local matrix of each node of `batch` to `out`, as `baked::local_matrix()`
+		/// would. Blocks of nodes are split into one array per component first, so the matrix
+		/// math runs over contiguous lanes the compiler turns into SIMD on any target, without
+		/// intrinsics or aligned glm types.
+		inline void compose_locals(
+			std::span<const baked::Node> nodes, std::span<const uint32_t> batch,
+			std::span<glm::mat4> out
+		) {
+			for (size_t first = 0; first < batch.size(); first += compose_block) {
+				const auto count = std::min(compose_block, batch.size() - first);
+
+				// Lanes past `count` stay zero and are never written back.
+				std::array<float, compose_block> x {}, y {}, z {}, w {}, sx {}, sy {}, sz {};
+				for (size_t k = 0; k < count; ++k) {
+					const auto& node = nodes[batch[first + k]];
+					x[k]			 = node.rotation.x;
+					y[k]			 = node.rotation.y;
+					z[k]			 = node.rotation.z;
+					w[k]			 = node.rotation.w;
+					sx[k]			 = node.scale.x;
+					sy[k]			 = node.scale.y;
+					sz[k]			 = node.scale.z;
+				}
+
+				// Rotation times scale, column-major; no branches or calls in the loop.
+				std::array<std::array<float, compose_block>, 9> m;
+				for (size_t k = 0; k < compose_block; ++k) {
+					const float xx = x[k] * x[k], yy = y[k] * y[k], zz = z[k] * z[k];
+					const float xy = x[k] * y[k], xz = x[k] * z[k], yz = y[k] * z[k];
+					const float wx = w[k] * x[k], wy = w[k] * y[k], wz = w[k] * z[k];
+					m[0][k] = (1.f - 2.f * (yy + zz)) * sx[k];
+					m[1][k] = 2.f * (xy + wz) * sx[k];
+					m[2][k] = 2.f * (xz - wy) * sx[k];
+					m[3][k] = 2.f * (xy - wz) * sy[k];
+					m[4][k] = (1.f - 2.f * (xx + zz)) * sy[k];
+					m[5][k] = 2.f * (yz + wx) * sy[k];
+					m[6][k] = 2.f * (xz + wy) * sz[k];
+					m[7][k] = 2.f * (yz - wx) * sz[k];
+					m[8][k] = (1.f - 2.f * (xx + yy)) * sz[k];
+				}
+
+				for (size_t k = 0; k < count; ++k)
+					out[first + k] = {
+						glm::vec4 { m[0][k], m[1][k], m[2][k], 0.f },
+						glm::vec4 { m[3][k], m[4][k], m[5][k], 0.f },
+						glm::vec4 { m[6][k], m[7][k], m[8][k], 0.f },
+						glm::vec4 { nodes[batch[first + k]].translation, 1.f },
+					};
+			}
+		}
+	}  // namespace details::scene_graph
+
+	/// Runtime node hierarchy: local TRS values and parent indices in topological order, plus
+	/// world matrices that are only recomputed below nodes whose local transform changed.
+	///
+	/// `world()` has one extra trailing identity matrix, `identity_index()`, for draws that must
+	/// not be transformed.
+	class SceneGraph {
+	public:
+		SceneGraph() = default;
+
+		/// `nodes` must be sorted parents first, as baked.
+		explicit SceneGraph(std::span<const baked::Node> nodes) :
+			_local(nodes.begin(), nodes.end()), _world(nodes.size() + 1, glm::mat4 { 1.f }),
+			_dirty(nodes.size(), 1) {
+			update();
+		}
+
+	public:
+		[[nodiscard]] auto size() const -> size_t { return _local.size(); }
+
+		[[nodiscard]] auto identity_index() const -> uint32_t {
+			return static_cast<uint32_t>(_local.size());
+		}
+
+		[[nodiscard]] auto local(size_t node) const -> const baked::Node& { return _local[node]; }
+
+		[[nodiscard]] auto parent(size_t node) const -> int32_t { return _local[node].parent; }
+
+		[[nodiscard]] auto world() const -> std::span<const glm::mat4> { return _world; }
+
+		/// Nodes may be modified concurrently as long as every thread touches different ones.
+		void set_rotation(size_t node, const glm::quat& rotation) {
+			_local[node].rotation = rotation;
+			_dirty[node]		  = 1;
+		}
+
+		void set_translation(size_t node, const glm::vec3& translation) {
+			_local[node].translation = translation;
+			_dirty[node]			 = 1;
+		}
+
+		void set_scale(size_t node, const glm::vec3& scale) {
+			_local[node].scale = scale;
+			_dirty[node]	   = 1;
+		}
+
+		/// Recomputes the world matrices of dirty nodes and their descendants. Several stages may
+		/// update in turn within a frame; `take_changed()` collects what they changed.
+		void update() {
+			// Parents come first, so a single pass spreads dirtiness down every subtree.
+			_batch.clear();
+			for (size_t i = 0; i < _local.size(); ++i) {
+				const auto parent = _local[i].parent;
+				if (parent >= 0 && _dirty[parent])
+					_dirty[i] = 1;
+				if (_dirty[i])
+					_batch.push_back(static_cast<uint32_t>(i));
+			}
+			if (_batch.empty())
+				return;
+
+			// Local matrices are independent: compose the whole batch over SoA lanes first, then
+			// chain them to their parents in order, which is inherently sequential.
+			_batch_local.resize(_batch.size());
+			details::scene_graph::compose_locals(_local, _batch, _batch_local);
+			for (size_t k = 0; k < _batch.size(); ++k) {
+				const auto i	  = _batch[k];
+				const auto parent = _local[i].parent;
+				_world[i] = parent >= 0 ? _world[parent] * _batch_local[k] : _batch_local[k];
+				_dirty[i] = 0;
+			}
+			_changed = { std::min(_changed.first, size_t { _batch.front() }),
+						 std::max(_changed.second, size_t { _batch.back() } + 1) };
+		}
+
+		/// Range of `world()` changed since the last call as `[first, last)`, empty if none.
+		auto take_changed() -> std::pair<size_t, size_t> {
+			const auto changed = std::exchange(_changed, { _local.size(), 0 });
+			return changed.first < changed.second ? changed : std::pair<size_t, size_t> { 0, 0 };
+		}
+
+	private:
+		std::vector<baked::Node> _local;
+		std::vector<glm::mat4>	 _world;
+		std::vector<uint8_t>	 _dirty;  // not `vector<bool>`, nodes are set from several threads
+
+		std::vector<uint32_t>	  _batch;
+		std::vector<glm::mat4>	  _batch_local;
+		std::pair<size_t, size_t> _changed = { 0, 0 };
+	};
+}  // namespace dvdbchar
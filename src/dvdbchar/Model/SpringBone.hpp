@@ -0,0 +1,390 @@
+#pragma once
+
+#include "dvdbchar/Model/BakedModel.hpp"
+#include "dvdbchar/Model/SceneGraph.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <range/v3/all.hpp>
+#include <stdexec/execution.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace dvdbchar {
+	namespace details::spring_bone {
+		/// Three float streams; `x[i], y[i], z[i]` is the i-th vector.
+		struct Vec3s {
+			std::vector<float> x, y, z;
+
+			void resize(size_t size) {
+				x.resize(size);
+				y.resize(size);
+				z.resize(size);
+			}
+
+			[[nodiscard]] auto get(size_t i) const -> glm::vec3 { return { x[i], y[i], z[i] }; }
+
+			void set(size_t i, const glm::vec3& v) {
+				x[i] = v.x;
+				y[i] = v.y;
+				z[i] = v.z;
+			}
+		};
+	}  // namespace details::spring_bone
+
+	/// VRMC_springBone secondary motion.
+	///
+	/// Simulated joints live in SoA streams, ordered per batch by depth along their chain and
+	/// then by chain, so one depth of many chains is integrated by a single branch-free loop
+	/// the compiler vectorizes. Collision runs the same way, one such loop per collider over the
+	/// joints of a depth. Only the transform bookkeeping between depths is scalar. Batches of
+	/// independent chains run in parallel on a small thread pool.
+	class SpringBoneSolver {
+	public:
+		struct Spec {
+			uint32_t threads  = 4;			 // chains are split into at most this many batches
+			float	 max_step = 1.f / 30.f;	 // longer frames are simulated as this long
+		};
+
+	public:
+		SpringBoneSolver() = default;
+
+		/// Starts every chain at rest in the current pose of `scene`, built from `baked`'s nodes.
+		SpringBoneSolver(const BakedModel& baked, const SceneGraph& scene, const Spec& spec = {}) :
+			_spec(spec) {
+			const auto nodes  = baked.nodes();
+			const auto joints = baked.spring_joints();
+			const auto world  = scene.world();
+
+			// A chain simulates every joint whose successor is its child; the successor is the
+			// tail. Anything past a break in the hierarchy is dropped.
+			struct Chain {
+				const baked::Spring* spring;
+				uint32_t			 length;
+			};
+			std::vector<Chain> chains;
+			for (const auto& spring : baked.springs()) {
+				uint32_t length = 0;
+				while (length + 1 < spring.joint_count
+					   && nodes[joints[spring.first_joint + length + 1].node].parent
+							  == static_cast<int32_t>(joints[spring.first_joint + length].node))
+					++length;
+				if (length > 0)
+					chains.push_back({ &spring, length });
+			}
+			if (chains.empty())
+				return;
+
+			// Longest chains first, each to the batch with the fewest joints so far.
+			std::ranges::stable_sort(chains, std::greater {}, &Chain::length);
+			const auto batch_count = std::clamp<size_t>(spec.threads, 1, chains.size());
+			std::vector<std::vector<Chain>> batch_chains(batch_count);
+			std::vector<uint32_t>			batch_joints(batch_count, 0);
+			for (const auto& chain : chains) {
+				const auto lightest = std::ranges::min_element(batch_joints) - batch_joints.begin();
+				batch_chains[lightest].push_back(chain);
+				batch_joints[lightest] += chain.length;
+			}
+
+			const auto slots = std::reduce(batch_joints.begin(), batch_joints.end(), size_t { 0 });
+			_resize(slots);
+			std::vector<uint32_t> first_collider(slots), collider_count(slots);
+			uint32_t			  slot = 0;
+			for (const auto& members : batch_chains) {
+				auto& batch = _batches.emplace_back();
+				for (uint32_t depth = 0; depth < members.front().length; ++depth) {
+					batch.depths.push_back(slot);
+					for (const auto& [lane, chain] : ranges::views::enumerate(members)) {
+						if (depth >= chain.length)
+							break;	// sorted by length, no later lane is this deep
+						const auto& spring = *chain.spring;
+						const auto& joint  = joints[spring.first_joint + depth];
+						const auto& tail   = joints[spring.first_joint + depth + 1];
+
+						const auto head_position = glm::vec3 { world[joint.node][3] };
+						const auto tail_position = glm::vec3 { world[tail.node][3] };
+
+						_node[slot]			 = joint.node;
+						_parent_slot[slot]	 = depth > 0
+											   ? static_cast<int32_t>(
+													 batch.depths[depth - 1] + lane
+												 )
+											   : -1;
+						_rest_rotation[slot] = nodes[joint.node].rotation;
+						_axis[slot]			 = glm::normalize(nodes[tail.node].translation);
+						first_collider[slot] = spring.first_collider;
+						collider_count[slot] = spring.collider_count;
+						_length[slot]		 = glm::distance(head_position, tail_position);
+						_hit_radius[slot]	 = joint.hit_radius;
+						_stiffness[slot]	 = joint.stiffness;
+						_drag[slot]			 = joint.drag_force;
+						_gravity.set(slot, joint.gravity);
+						_current.set(slot, tail_position);
+						_previous.set(slot, tail_position);
+						++slot;
+					}
+				}
+				batch.depths.push_back(slot);
+
+				// One pass per collider any joint of a depth uses; a joint whose spring does not
+				// use it gets a zero weight.
+				const auto spring_colliders = baked.spring_colliders();
+				const auto uses				= [&](uint32_t joint, uint32_t collider) {
+					const auto list = spring_colliders.subspan(
+						first_collider[joint],
+						collider_count[joint]
+					);
+					return std::ranges::find(list, collider) != list.end();
+				};
+				for (size_t depth = 0; depth + 1 < batch.depths.size(); ++depth) {
+					const auto begin = batch.depths[depth], end = batch.depths[depth + 1];
+					batch.passes.push_back(static_cast<uint32_t>(_passes.size()));
+
+					std::vector<uint32_t> used;
+					for (auto i = begin; i < end; ++i)
+						for (uint32_t k = 0; k < collider_count[i]; ++k)
+							used.push_back(spring_colliders[first_collider[i] + k]);
+					std::ranges::sort(used);
+					used.erase(std::ranges::unique(used).begin(), used.end());
+
+					for (const auto collider : used) {
+						_passes.push_back({
+							.collider = collider,
+							.weights  = static_cast<uint32_t>(_pass_weights.size()),
+						});
+						for (auto i = begin; i < end; ++i)
+							_pass_weights.push_back(uses(i, collider) ? 1.f : 0.f);
+					}
+				}
+				batch.passes.push_back(static_cast<uint32_t>(_passes.size()));
+			}
+
+			const auto colliders = baked.colliders();
+			_colliders.assign(colliders.begin(), colliders.end());
+			_collider_heads.resize(_colliders.size());
+			_collider_tails.resize(_colliders.size());
+
+			if (_batches.size() > 1)
+				_pool = std::make_unique<exec::static_thread_pool>(
+					static_cast<uint32_t>(_batches.size())
+				);
+		}
+
+	public:
+		[[nodiscard]] auto empty() const -> bool { return _batches.empty(); }
+
+		[[nodiscard]] auto joint_count() const -> size_t { return _node.size(); }
+
+		/// Advances the simulation by `dt` seconds from the up to date world transforms of
+		/// `scene`, and sets the local rotations of the simulated joints. `scene.update()` has to
+		/// run again afterwards.
+		void update(float dt, SceneGraph& scene) {
+			if (empty())
+				return;
+			dt				 = std::min(dt, _spec.max_step);
+			const auto world = scene.world();
+
+			for (const auto& [i, collider] : ranges::views::enumerate(_colliders)) {
+				const auto& transform = world[collider.node];
+				const auto	head	  = transform * glm::vec4 { collider.offset, 1.f };
+				const auto	tail	  = transform * glm::vec4 { collider.tail, 1.f };
+				_collider_heads.set(i, glm::vec3 { head });
+				_collider_tails.set(i, glm::vec3 { tail });
+			}
+
+			if (!_pool) {
+				_simulate(_batches.front(), dt, scene);
+				return;
+			}
+			stdexec::sync_wait(
+				stdexec::schedule(_pool->get_scheduler())  //
+				| stdexec::bulk(stdexec::par, _batches.size(), [&](size_t i) {
+					  _simulate(_batches[i], dt, scene);
+				  })
+			);
+		}
+
+	private:
+		/// Slot offsets of one batch: `depths[k]` to `depths[k + 1]` are the joints at depth k,
+		/// tested against the colliders of `_passes[passes[k]]` to `_passes[passes[k + 1]]`.
+		struct Batch {
+			std::vector<uint32_t> depths;
+			std::vector<uint32_t> passes;
+		};
+
+		/// One collider tested against every joint of a depth, weighted by `_pass_weights`
+		/// from `weights` on: 1 if the joint's spring uses the collider, else 0.
+		struct ColliderPass {
+			uint32_t collider;
+			uint32_t weights;
+		};
+
+		void _resize(size_t size) {
+			_node.resize(size);
+			_parent_slot.resize(size);
+			_rest_rotation.resize(size);
+			_axis.resize(size);
+			_world.resize(size);
+			_length.resize(size);
+			_hit_radius.resize(size);
+			_stiffness.resize(size);
+			_drag.resize(size);
+			_gravity.resize(size);
+			_head.resize(size);
+			_stiffness_dir.resize(size);
+			_current.resize(size);
+			_previous.resize(size);
+		}
+
+		void _simulate(const Batch& batch, float dt, SceneGraph& scene) {
+			for (size_t depth = 0; depth + 1 < batch.depths.size(); ++depth) {
+				const size_t begin = batch.depths[depth], end = batch.depths[depth + 1];
+				_prepare(begin, end, scene);
+				_integrate(begin, end, dt);
+				_collide(batch, depth, begin, end);
+				_rotate(begin, end, scene);
+			}
+		}
+
+		[[nodiscard]] auto _parent_world(size_t slot, const SceneGraph& scene) const -> glm::mat4 {
+			if (_parent_slot[slot] >= 0)
+				return _world[_parent_slot[slot]];
+			const auto parent = scene.parent(_node[slot]);
+			return parent >= 0 ? scene.world()[parent] : glm::mat4 { 1.f };
+		}
+
+		/// Joint heads and the direction stiffness pulls towards, from the rest rotation under
+		/// the freshly simulated parent.
+		void _prepare(size_t begin, size_t end, const SceneGraph& scene) {
+			for (size_t i = begin; i < end; ++i) {
+				auto rest		= scene.local(_node[i]);
+				rest.rotation	= _rest_rotation[i];
+				const auto head = _parent_world(i, scene) * baked::local_matrix(rest);
+				_head.set(i, glm::vec3 { head[3] });
+				_stiffness_dir.set(i, glm::normalize(glm::mat3 { head } * _axis[i]));
+			}
+		}
+
+		/// Verlet step and bone length constraint over plain float streams.
+		void _integrate(size_t begin, size_t end, float dt) {
+			for (size_t i = begin; i < end; ++i) {
+				const float inertia = 1.f - _drag[i];
+				const float pull	= _stiffness[i] * dt;
+				const float x		= _current.x[i] + (_current.x[i] - _previous.x[i]) * inertia
+								+ _stiffness_dir.x[i] * pull + _gravity.x[i] * dt;
+				const float y		= _current.y[i] + (_current.y[i] - _previous.y[i]) * inertia
+								+ _stiffness_dir.y[i] * pull + _gravity.y[i] * dt;
+				const float z		= _current.z[i] + (_current.z[i] - _previous.z[i]) * inertia
+								+ _stiffness_dir.z[i] * pull + _gravity.z[i] * dt;
+
+				const float dx	  = x - _head.x[i];
+				const float dy	  = y - _head.y[i];
+				const float dz	  = z - _head.z[i];
+				const float norm  = std::sqrt(dx * dx + dy * dy + dz * dz);
+				const float scale = _length[i] / std::max(norm, 1e-6f);
+
+				_previous.x[i] = _current.x[i];
+				_previous.y[i] = _current.y[i];
+				_previous.z[i] = _current.z[i];
+				_current.x[i]  = _head.x[i] + dx * scale;
+				_current.y[i]  = _head.y[i] + dy * scale;
+				_current.z[i]  = _head.z[i] + dz * scale;
+			}
+		}
+
+		/// Pushes tails out of the sphere and capsule colliders of their spring, then back onto
+		/// the bone length. Colliders are the outer loop, so each is one branch-free loop over
+		/// float streams: a miss or an unused collider blends the tail with weight zero.
+		void _collide(const Batch& batch, size_t depth, size_t begin, size_t end) {
+			for (auto p = batch.passes[depth]; p < batch.passes[depth + 1]; ++p) {
+				const auto&	 pass	 = _passes[p];
+				const auto	 a		 = _collider_heads.get(pass.collider);
+				const auto	 ab		 = _collider_tails.get(pass.collider) - a;
+				const float	 inv_ab	 = 1.f / std::max(glm::dot(ab, ab), 1e-12f);
+				const float	 radius	 = _colliders[pass.collider].radius;
+				const float* weights = _pass_weights.data() + pass.weights;
+				for (size_t i = begin; i < end; ++i) {
+					const float tx	  = _current.x[i];
+					const float ty	  = _current.y[i];
+					const float tz	  = _current.z[i];
+					const float along = std::clamp(
+						((tx - a.x) * ab.x + (ty - a.y) * ab.y + (tz - a.z) * ab.z) * inv_ab,
+						0.f,
+						1.f
+					);
+					const float ox	  = tx - (a.x + ab.x * along);
+					const float oy	  = ty - (a.y + ab.y * along);
+					const float oz	  = tz - (a.z + ab.z * along);
+					const float dist  = std::sqrt(ox * ox + oy * oy + oz * oz);
+					const float reach = radius + _hit_radius[i];
+					const float hit	  = dist < reach && dist > 0.f ? weights[i - begin] : 0.f;
+
+					// Onto the collider surface, then back onto the bone length from the head.
+					const float push = reach / std::max(dist, 1e-6f) - 1.f;
+					const float bx	 = tx + ox * push - _head.x[i];
+					const float by	 = ty + oy * push - _head.y[i];
+					const float bz	 = tz + oz * push - _head.z[i];
+					const float keep =
+						_length[i] / std::max(std::sqrt(bx * bx + by * by + bz * bz), 1e-6f);
+					_current.x[i] = tx + (_head.x[i] + bx * keep - tx) * hit;
+					_current.y[i] = ty + (_head.y[i] + by * keep - ty) * hit;
+					_current.z[i] = tz + (_head.z[i] + bz * keep - tz) * hit;
+				}
+			}
+		}
+
+		/// Turns each joint so its bone points at the simulated tail.
+		void _rotate(size_t begin, size_t end, SceneGraph& scene) {
+			for (size_t i = begin; i < end; ++i) {
+				using details::scene_graph::rotation_between;
+
+				const auto parent = _parent_world(i, scene);
+				const auto bone	  = _current.get(i) - _head.get(i);
+				const auto to	  = glm::normalize(
+					  glm::inverse(_rest_rotation[i]) * (glm::inverse(glm::mat3 { parent }) * bone)
+				  );
+
+				auto local	   = scene.local(_node[i]);
+				local.rotation = _rest_rotation[i] * rotation_between(_axis[i], to);
+				scene.set_rotation(_node[i], local.rotation);
+				_world[i] = parent * baked::local_matrix(local);
+			}
+		}
+
+	private:
+		Spec									  _spec;
+		std::vector<Batch>						  _batches;
+		std::unique_ptr<exec::static_thread_pool> _pool;  // only with more than one batch
+
+		// Per joint, scalar side
+		std::vector<uint32_t>  _node;
+		std::vector<int32_t>   _parent_slot;  // -1: the parent is not simulated
+		std::vector<glm::quat> _rest_rotation;
+		std::vector<glm::vec3> _axis;  // towards the tail, in joint space
+		std::vector<glm::mat4> _world;
+
+		// Per joint, vectorized side
+		std::vector<float>			_length;
+		std::vector<float>			_hit_radius;
+		std::vector<float>			_stiffness;
+		std::vector<float>			_drag;
+		details::spring_bone::Vec3s _gravity;
+		details::spring_bone::Vec3s _head;
+		details::spring_bone::Vec3s _stiffness_dir;
+		details::spring_bone::Vec3s _current;
+		details::spring_bone::Vec3s _previous;
+
+		// Colliders
+		std::vector<baked::Collider> _colliders;
+		std::vector<ColliderPass>	 _passes;
+		std::vector<float>			 _pass_weights;
+		details::spring_bone::Vec3s	 _collider_heads;
+		details::spring_bone::Vec3s	 _collider_tails;
+	};
+}  // namespace dvdbchar
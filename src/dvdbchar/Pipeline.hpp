@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dvdbchar/Glfw.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
 
 #include <spdlog/spdlog.h>
 #include <webgpu/webgpu_cpp.h>
@@ -17,9 +18,11 @@
 
 #include <cstdint>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 #include <span>
 #include <utility>
+#include <vector>
 
 namespace dvdbchar {
 	using exec::task;
@@ -225,24 +228,29 @@ namespace dvdbchar {
 
 		auto write_buffer(std::span<const T> data) { return WriteBufferSender { *this, data }; }
 
+		/// Records the copy into `uploads`, submitted with the frame's other uploads.
 		template<wgpu::BufferUsage another_usage>
 		friend auto bufcpy(
-			const wgpu::Device& device, const wgpu::Queue& queue, const Buffer& dst,
-			const Buffer<T, another_usage>& src
+			Render::UploadContext& uploads, const Buffer& dst, const Buffer<T, another_usage>& src
 		) {
-			auto encoder = device.CreateCommandEncoder();
-			encoder.CopyBufferToBuffer(src.get(), 0, dst.get(), 0, src.size() * sizeof(T));
-			const auto cmd = encoder.Finish();
-			queue.Submit(1, &cmd);
+			uploads.copy(src.get(), 0, dst.get(), 0, src.size() * sizeof(T));
 		}
 
-		// auto async_read() const {
-		// 	static_assert(
-		// 		usage & wgpu::BufferUsage::MapWrite,
-		// 		"Buffer cannot be `async_read`ed unless it contains `wgpu::BufferUsage::MapRead`!"
-		// 	);
-		// 	return MapReadRequestSender { _buffer };
-		// }
+		/// Completes with a copy of the contents once the GPU is done writing them.
+		auto async_read() {
+			static_assert(
+				usage & wgpu::BufferUsage::MapRead,
+				"Buffer cannot be `async_read`ed unless it contains `wgpu::BufferUsage::MapRead`!"
+			);
+
+			using namespace stdexec;
+			return MapReadRequestSender { _buffer, 0, size() * sizeof(T) } | then([&](auto&&...) {
+					   const auto*	  data = static_cast<const T*>(_buffer.GetConstMappedRange());
+					   std::vector<T> values(data, data + size());
+					   _buffer.Unmap();
+					   return values;
+				   });
+		}
 
 		auto async_write() {
 			static_assert(
@@ -353,6 +361,8 @@ namespace dvdbchar {
 	template<typename T>
 	using StagingBuffer = Buffer<T, wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc>;
 
+	/// Buffer written through a `Render::UploadContext`: every write is a staged copy submitted
+	/// with the frame's other uploads, so writes neither wait for nor cancel one another.
 	template<typename T, wgpu::BufferUsage usage>
 		requires(((uint32_t)usage & (uint32_t)wgpu::BufferUsage::CopyDst) != 0)
 	class StagedBuffer : protected Buffer<T, usage> {
@@ -362,143 +372,21 @@ namespace dvdbchar {
 	public:
 		StagedBuffer() = default;
 
-		StagedBuffer(const wgpu::Device& device, size_t size = 1) :
-			_device(&device), OriginalBufferT(device, size), _staging(device, size) {}
+		StagedBuffer(const wgpu::Device& device, size_t size = 1) : OriginalBufferT(device, size) {}
 
 	public:
-		auto async_write(std::invocable<T&> auto&& f) {
-			if (!_state->_available) {
-				_state->_cancelling = true;
-				_staging.get().Unmap();
-			}
-			_state->_available = false;
-			_staging.async_write_no_unmap([&, f = std::forward<decltype(f)>(f)](T& data) {
-				if (_state->_cancelling) {
-					_state->_available	= true;
-					_state->_cancelling = false;
-					return;
-				}
-				std::invoke(std::forward<decltype(f)>(f), data);
-				_staging.get().Unmap();
-
-				bufcpy(
-					*_device,
-					_device->GetQueue(),
-					static_cast<OriginalBufferT&>(*this),
-					_staging
-				);
-				_state->_available = true;
-			});
-		}
-
-		auto async_write(T&& data) {
-			if (!_state->_available) {
-				_state->_cancelling = true;
-				_staging.get().Unmap();
-			}
-			_state->_available = false;
-			_staging.async_write_no_unmap([&, data = std::forward<T>(data)](T& d) {
-				if (_state->_cancelling) {
-					_state->_available	= true;
-					_state->_cancelling = false;
-					return;
-				}
-				d = std::move(data);
-				_staging.get().Unmap();
-
-				bufcpy(
-					*_device,
-					_device->GetQueue(),
-					static_cast<OriginalBufferT&>(*this),
-					_staging
-				);
-				_state->_available = true;
-			});
-		}
-
-		auto async_write(std::span<const T> data) {
-			if (!_state->_available) {
-				_state->_cancelling = true;
-				_staging.get().Unmap();
-			}
-			_state->_available = false;
-			_staging.get().MapAsync(
-				wgpu::MapMode::Write,
-				0,
-				data.size() * sizeof(T),
-				wgpu::CallbackMode::AllowProcessEvents,
-				[&, data](wgpu::MapAsyncStatus status, wgpu::StringView) {
-					if (_state->_cancelling) {
-						_state->_available	= true;
-						_state->_cancelling = false;
-						return;
-					}
-					void* p = _staging.get().GetMappedRange();
-					std::memcpy(p, data.data(), data.size() * sizeof(T));
-					_staging.get().Unmap();
-
-					bufcpy(
-						*_device,
-						_device->GetQueue(),
-						static_cast<OriginalBufferT&>(*this),
-						_staging
-					);
-					_state->_available = true;
-				}
-			);
+		void write(Render::UploadContext& uploads, std::span<const T> data) {
+			uploads.write(this->get(), 0, std::as_bytes(data));
 		}
 
-		auto async_write(std::vector<T>&& data) {
-			if (!_state->_available) {
-				_state->_cancelling = true;
-				_staging.get().Unmap();
-			}
-			_state->_available = false;
-			_staging.get().MapAsync(
-				wgpu::MapMode::Write,
-				0,
-				_staging.size() * sizeof(T),
-				wgpu::CallbackMode::AllowProcessEvents,
-				[&, data = std::move(data)](wgpu::MapAsyncStatus status, wgpu::StringView) {
-					if (_state->_cancelling) {
-						_state->_available	= true;
-						_state->_cancelling = false;
-						return;
-					}
-					void* p = _staging.get().GetMappedRange();
-					std::memcpy(p, data.data(), data.size() * sizeof(T));
-					_staging.get().Unmap();
-
-					spdlog::info("writing:");
-					for (const auto& d : data)
-						spdlog::info("{}, {}, {}", d.pos.x, d.pos.y, d.pos.z);
-
-					bufcpy(
-						*_device,
-						_device->GetQueue(),
-						static_cast<OriginalBufferT&>(*this),
-						_staging
-					);
-					_state->_available = true;
-				}
-			);
+		void write(Render::UploadContext& uploads, const T& data) {
+			write(uploads, std::span { &data, 1 });
 		}
 
 		using OriginalBufferT::get;
 		using OriginalBufferT::write_buffer;
 		using OriginalBufferT::operator*;
 		using OriginalBufferT::operator->;
-
-	protected:
-		struct State {
-			std::atomic<bool> _available  = true;
-			std::atomic<bool> _cancelling = false;
-		};
-
-	protected:
-		const wgpu::Device*	   _device;
-		StagingBuffer<T>	   _staging;
-		std::unique_ptr<State> _state = std::make_unique<State>(true, false);
 	};
 
 	template<typename T>
@@ -574,7 +462,8 @@ namespace dvdbchar {
 		wgpu::TextureFormat			_format;
 		wgpu::RenderPipeline		_pipeline;
 
-		StagedVertexBuffer<Vertice> _vertex;
+		StagedVertexBuffer<Vertice>			 _vertex;
+		std::optional<Render::UploadContext> _uploads;  // needs `_device`
 	};
 }  // namespace dvdbchar
 
@@ -652,14 +541,7 @@ namespace dvdbchar {
 		// 	}
 		// );
 		_vertex = std::move(StagedVertexBuffer<Vertice> { _device, 3 });
-
-		_vertex.async_write(
-			std::vector {
-				Vertice { .pos = { .0, -.5, .0 } },
-				Vertice { .pos = { .5, .5, .0 } },
-				Vertice { .pos = { -.5, .5, .0 } },
-			}
-		);
+		_uploads.emplace(_device);
 	}
 
 	inline void LegacyPipeline::_init_window(const Spec& spec) {
@@ -767,9 +649,6 @@ namespace dvdbchar {
 		static auto time = std::chrono::high_resolution_clock::now();
 		data[0].pos.x = ((std::chrono::high_resolution_clock::now() - time).count() % 1000) * .001f;
 
-		// _queue.WriteBuffer(_vertex.get(), 0, data.data(), data.size() * sizeof(Vertice));
-		_vertex.async_write(data);
-
 		const wgpu::RenderPassColorAttachment attachment {
 			.view	 = tex.texture.CreateView(),
 			.loadOp	 = wgpu::LoadOp::Clear,
@@ -781,6 +660,8 @@ namespace dvdbchar {
 			.colorAttachments	  = &attachment,
 		};
 
+		_vertex.write(*_uploads, data);
+
 		wgpu::CommandEncoder	encoder = _device.CreateCommandEncoder();
 		wgpu::RenderPassEncoder pass	= encoder.BeginRenderPass(&renderpass);
 		pass.SetPipeline(_pipeline);
@@ -788,6 +669,6 @@ namespace dvdbchar {
 		pass.Draw(3);
 		pass.End();
 		wgpu::CommandBuffer commands = encoder.Finish();
-		_device.GetQueue().Submit(1, &commands);
+		_uploads->submit(std::span { &commands, 1 });
 	}
 }  // namespace dvdbchar
\ No newline at end of file
@@ -2,11 +2,25 @@
 
 #include "Context.hpp"
 #include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
 #include "dvdbchar/Render/ShaderReflection.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
 
 #include <webgpu/webgpu_cpp.h>
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <span>
+#include <utility>
+#include <vector>
 
 namespace dvdbchar::Render {
 	template<wgpu::BufferUsage usage = wgpu::BufferUsage::None>
@@ -222,22 +236,13 @@ namespace dvdbchar::Render {
 			return AsyncWriteSender { *this, data };
 		}
 
+		/// Records the copy into `uploads`, submitted with the frame's other uploads.
 		template<typename DstT, wgpu::BufferUsage dst_usage>
 		auto copy_to(
-			const LegacyBuffer<DstT, dst_usage>& dst, size_t src_offset = 0, size_t dst_offset = 0,
-			size_t size = 1
+			UploadContext& uploads, const LegacyBuffer<DstT, dst_usage>& dst, size_t src_offset = 0,
+			size_t dst_offset = 0, size_t size = 1
 		) {
-			using namespace stdexec;
-			return	//
-				read_env(get_scheduler) | then([&](auto&& sched) {
-					const wgpu::Queue&	queue  = WgpuContext::query_queue(sched).get();
-					const wgpu::Device& device = WgpuContext::query_device(sched).get();
-
-					auto				cmd	   = device.CreateCommandEncoder();
-					cmd.CopyBufferToBuffer(*this, src_offset, dst, dst_offset, sizeof(T) * size);
-					auto cb = cmd.Finish();
-					queue.Submit(1, &cb);
-				});
+			uploads.copy(*this, src_offset, dst, dst_offset, sizeof(T) * size);
 		}
 
 	private:
@@ -249,7 +254,7 @@ namespace dvdbchar::Render {
 		LegacyBuffer<T, wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst>;
 
 	template<typename T, wgpu::BufferUsage usage>
-	class ArrayBuffer : public wgpu::Buffer {
+	class ArrayBuffer : public TrackedBuffer {
 	public:
 		ArrayBuffer(const WgpuContext& ctx, std::span<const T> data) {
 			const wgpu::BufferDescriptor buffer_desc = {
@@ -257,7 +262,7 @@ namespace dvdbchar::Render {
 				.size			  = data.size() * sizeof(T),
 				.mappedAtCreation = false,
 			};
-			static_cast<wgpu::Buffer&>(*this) = ctx.device.CreateBuffer(&buffer_desc);
+			static_cast<TrackedBuffer&>(*this) = create_buffer(ctx, buffer_desc);
 
 			ctx.queue.WriteBuffer(*this, 0, data.data(), data.size() * sizeof(T));
 		}
@@ -268,7 +273,7 @@ namespace dvdbchar::Render {
 				.size			  = size,
 				.mappedAtCreation = false,
 			};
-			static_cast<wgpu::Buffer&>(*this) = ctx.device.CreateBuffer(&buffer_desc);
+			static_cast<TrackedBuffer&>(*this) = create_buffer(ctx, buffer_desc);
 		}
 
 		ArrayBuffer(std::span<const T> data) : ArrayBuffer(WgpuContext::global(), data) {}
@@ -301,7 +306,7 @@ namespace dvdbchar::Render {
 		ArrayBuffer<uint32_t, wgpu::BufferUsage::Index | wgpu::BufferUsage::CopyDst>;
 
 	template<typename T>
-	class StaticVertexBuffer : public wgpu::Buffer {
+	class StaticVertexBuffer : public TrackedBuffer {
 	public:
 		inline static constexpr auto usage = wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst;
 
@@ -315,7 +320,7 @@ namespace dvdbchar::Render {
 				.size			  = sizeof(T) * data.size(),
 				.mappedAtCreation = false,
 			};
-			static_cast<wgpu::Buffer&>(*this) = ctx.device.CreateBuffer(&buffer_desc);
+			static_cast<TrackedBuffer&>(*this) = create_buffer(ctx, buffer_desc);
 
 			// MapAsync(
 			// 	wgpu::MapMode::Write,
@@ -353,20 +358,23 @@ namespace dvdbchar::Render {
 	template<typename T>
 	class ReflectedUniformBuffer {};
 
+	/// Uniform block written through a CPU shadow copy. Field writes only touch the shadow and
+	/// widen its dirty range; `flush()` uploads that range with a single `WriteBuffer`, so
+	/// however many writes happen between frames cost one queue write.
 	template<ReflMapped T>
-	class ReflectedUniformBuffer<T> : public wgpu::Buffer, public ReflectedParameter<T> {
+	class ReflectedUniformBuffer<T> : public TrackedBuffer, public ReflectedParameter<T> {
 	public:
 		template<typename... Args>
 		ReflectedUniformBuffer(
 			const WgpuContext& ctx, const ReflectedParameter<T>& refl, Args&&... args
 		) :
-			ReflectedParameter<T>(refl) {
+			ReflectedParameter<T>(refl), _shadow(refl.size) {
 			const wgpu::BufferDescriptor buffer_desc = {
 				.usage			  = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
 				.size			  = refl.size,
 				.mappedAtCreation = false,
 			};
-			static_cast<wgpu::Buffer&>(*this) = ctx.device.CreateBuffer(&buffer_desc);
+			static_cast<TrackedBuffer&>(*this) = create_buffer(ctx, buffer_desc);
 		}
 
 		template<typename... Args>
@@ -375,14 +383,31 @@ namespace dvdbchar::Render {
 
 	public:
 		template<typename Data>
-		auto write(const WgpuContext& ctx, const Field<Data>& field, const Data& data) {
-			ctx.queue.WriteBuffer(*this, field.offset, &data, field.size);
+		auto write(const Field<Data>& field, const Data& data) {
+			std::memcpy(_shadow.data() + field.offset, &data, field.size);
+			_dirty_begin = std::min(_dirty_begin, field.offset);
+			_dirty_end	 = std::max(_dirty_end, field.offset + field.size);
 		}
 
-		template<typename Data>
-		auto write(const Field<Data>& field, const Data& data) {
-			return write(WgpuContext::global(), field, data);
+		/// Uploads everything written since the last flush. Call once per frame, before
+		/// submitting work that reads the block.
+		void flush(const WgpuContext& ctx) {
+			if (_dirty_begin >= _dirty_end)
+				return;
+			// `WriteBuffer` wants 4-byte aligned offsets and sizes.
+			const auto begin = _dirty_begin & ~size_t { 3 };
+			const auto end	 = std::min((_dirty_end + 3) & ~size_t { 3 }, _shadow.size());
+			ctx.queue.WriteBuffer(*this, begin, _shadow.data() + begin, end - begin);
+			_dirty_begin = std::numeric_limits<size_t>::max();
+			_dirty_end	 = 0;
 		}
+
+		void flush() { flush(WgpuContext::global()); }
+
+	private:
+		std::vector<std::byte> _shadow;
+		size_t				   _dirty_begin = std::numeric_limits<size_t>::max();
+		size_t				   _dirty_end	= 0;
 	};
 
 	// template<ParamMapped T>
@@ -422,46 +447,572 @@ namespace dvdbchar::Render {
 		};
 	}
 
-	class DynamicBuffer : public wgpu::Buffer {
+	namespace details::buffer_heap {
+		/// Two-level segregated fit allocator over `[0, size)`. Free blocks sit in lists indexed
+		/// by a power of two and 16 linear steps below it, found through two bitmaps, so both
+		/// allocation and freeing (which merges physical neighbours) are O(1).
+		class Tlsf {
+		public:
+			inline static constexpr uint32_t none = ~0u;
+
+			struct Block {
+				uint32_t offset;
+				uint32_t size;
+				uint32_t prev_phys = none;
+				uint32_t next_phys = none;
+				uint32_t prev_free = none;
+				uint32_t next_free = none;
+				uint32_t owner	   = none;	// opaque to the allocator
+				bool	 free	   = false;
+			};
+
+		public:
+			Tlsf() = default;
+
+			explicit Tlsf(uint32_t size) : _size(size) {
+				_blocks.push_back({ .offset = 0, .size = size });
+				_insert(0);
+			}
+
+		public:
+			/// Index of a block of at least `size`, or `none` if no free block is large enough.
+			[[nodiscard]] auto allocate(uint32_t size) -> uint32_t {
+				size			= std::max(size, 1u);
+				auto [fl, sl]	= _mapping(_round_up(size));
+				uint32_t sl_map = fl < fl_count ? _sl_bitmap[fl] & (~0u << sl) : 0;
+				if (!sl_map) {
+					const uint32_t fl_map = fl + 1 < fl_count ? _fl_bitmap & (~0u << (fl + 1)) : 0;
+					if (!fl_map)
+						return none;
+					fl	   = std::countr_zero(fl_map);
+					sl_map = _sl_bitmap[fl];
+				}
+				sl = std::countr_zero(sl_map);
+
+				const auto b = _heads[fl][sl];
+				_remove(b);
+				if (_blocks[b].size > size) {
+					const auto rest = _make({
+						.offset	   = _blocks[b].offset + size,
+						.size	   = _blocks[b].size - size,
+						.prev_phys = b,
+						.next_phys = _blocks[b].next_phys,
+					});
+					if (_blocks[rest].next_phys != none)
+						_blocks[_blocks[rest].next_phys].prev_phys = rest;
+					_blocks[b].next_phys = rest;
+					_blocks[b].size		 = size;
+					_insert(rest);
+				}
+				_used += size;
+				return b;
+			}
+
+			void free(uint32_t b) {
+				_used			  -= _blocks[b].size;
+				_blocks[b].owner   = none;
+
+				if (const auto next = _blocks[b].next_phys; next != none && _blocks[next].free) {
+					_remove(next);
+					_absorb(b, next);
+				}
+				if (const auto prev = _blocks[b].prev_phys; prev != none && _blocks[prev].free) {
+					_remove(prev);
+					_absorb(prev, b);
+					b = prev;
+				}
+				_insert(b);
+			}
+
+			[[nodiscard]] auto block(uint32_t b) const -> const Block& { return _blocks[b]; }
+
+			[[nodiscard]] auto block(uint32_t b) -> Block& { return _blocks[b]; }
+
+			[[nodiscard]] auto size() const -> uint32_t { return _size; }
+
+			[[nodiscard]] auto used() const -> uint32_t { return _used; }
+
+			/// Calls `f(index, block)` for every allocated block, in address order.
+			template<typename F>
+			void for_each_used(F&& f) const {
+				// Merging always keeps the lower block, so block 0 stays at offset 0.
+				for (uint32_t b = _blocks.empty() ? none : 0; b != none; b = _blocks[b].next_phys)
+					if (!_blocks[b].free)
+						f(b, _blocks[b]);
+			}
+
+		private:
+			inline static constexpr uint32_t sl_bits  = 4;
+			inline static constexpr uint32_t sl_count = 1 << sl_bits;
+			inline static constexpr uint32_t fl_count = 32 - sl_bits + 1;
+
+			/// Free list holding blocks of `size`.
+			[[nodiscard]] inline static constexpr auto _mapping(uint32_t size)
+				-> std::pair<uint32_t, uint32_t> {
+				if (size < sl_count)
+					return { 0, size };
+				const uint32_t f = std::bit_width(size) - 1;
+				return { f - sl_bits + 1, (size >> (f - sl_bits)) - sl_count };
+			}
+
+			/// Smallest size whose free list only holds blocks of at least `size`.
+			[[nodiscard]] inline static constexpr auto _round_up(uint32_t size) -> uint32_t {
+				if (size < sl_count)
+					return size;
+				const uint32_t f = std::bit_width(size) - 1;
+				return size + (1u << (f - sl_bits)) - 1;
+			}
+
+			[[nodiscard]] auto _make(const Block& block) -> uint32_t {
+				if (!_unused.empty()) {
+					const auto b = _unused.back();
+					_unused.pop_back();
+					_blocks[b] = block;
+					return b;
+				}
+				_blocks.push_back(block);
+				return static_cast<uint32_t>(_blocks.size() - 1);
+			}
+
+			/// Merges free block `next` into its physical predecessor `b`.
+			void _absorb(uint32_t b, uint32_t next) {
+				_blocks[b].size		 += _blocks[next].size;
+				_blocks[b].next_phys  = _blocks[next].next_phys;
+				if (_blocks[b].next_phys != none)
+					_blocks[_blocks[b].next_phys].prev_phys = b;
+				_unused.push_back(next);
+			}
+
+			void _insert(uint32_t b) {
+				const auto [fl, sl]	 = _mapping(_blocks[b].size);
+				auto& head			 = _heads[fl][sl];
+				_blocks[b].free		 = true;
+				_blocks[b].prev_free = none;
+				_blocks[b].next_free = head;
+				if (head != none)
+					_blocks[head].prev_free = b;
+				head			 = b;
+				_fl_bitmap		|= 1u << fl;
+				_sl_bitmap[fl]	|= 1u << sl;
+			}
+
+			void _remove(uint32_t b) {
+				const auto [fl, sl] = _mapping(_blocks[b].size);
+				const auto prev		= _blocks[b].prev_free;
+				const auto next		= _blocks[b].next_free;
+				if (prev != none)
+					_blocks[prev].next_free = next;
+				else
+					_heads[fl][sl] = next;
+				if (next != none)
+					_blocks[next].prev_free = prev;
+				_blocks[b].free = false;
+
+				if (_heads[fl][sl] == none && !(_sl_bitmap[fl] &= ~(1u << sl)))
+					_fl_bitmap &= ~(1u << fl);
+			}
+
+		private:
+			uint32_t											 _size = 0;
+			uint32_t											 _used = 0;
+			std::vector<Block>									 _blocks;
+			std::vector<uint32_t>								 _unused;  // recycled indices
+			uint32_t											 _fl_bitmap = 0;
+			std::array<uint32_t, fl_count>						 _sl_bitmap = {};
+			std::array<std::array<uint32_t, sl_count>, fl_count> _heads	= [] {
+				std::array<std::array<uint32_t, sl_count>, fl_count> heads;
+				for (auto& row : heads) row.fill(none);
+				return heads;
+			}();
+		};
+	}  // namespace details::buffer_heap
+
+	class DynamicBufferPool;
+
+	/// Range of a `DynamicBufferPool` page, returned to the pool when destroyed. The range may
+	/// move when the pool compacts, so look up `buffer()` and `offset()` again whenever the
+	/// pool's `generation()` changed.
+	class DynamicBuffer {
 	public:
-		struct Spec {};
+		DynamicBuffer() = default;
+
+		DynamicBuffer(DynamicBuffer&& other) noexcept :
+			_pool(std::exchange(other._pool, nullptr)), _slot(other._slot) {}
+
+		DynamicBuffer& operator=(DynamicBuffer&& other) noexcept {
+			if (this != &other) {
+				reset();
+				_pool = std::exchange(other._pool, nullptr);
+				_slot = other._slot;
+			}
+			return *this;
+		}
+
+		~DynamicBuffer() { reset(); }
 
 	public:
-		DynamicBuffer(const WgpuContext& ctx, const Spec& spec) {
-			const wgpu::BufferDescriptor desc {
+		explicit operator bool() const { return _pool != nullptr; }
 
-			};
+		[[nodiscard]] auto buffer() const -> wgpu::Buffer;
+
+		[[nodiscard]] auto offset() const -> uint64_t;
+
+		[[nodiscard]] auto size() const -> uint64_t;
+
+		[[nodiscard]] auto entry(uint32_t binding) const -> wgpu::BindGroupEntry {
+			return { .binding = binding, .buffer = buffer(), .offset = offset(), .size = size() };
 		}
+
+		/// Stages `data` on `uploads` for `offset` bytes into the range, a multiple of 4. A
+		/// ragged tail is padded with zeros, which the range's alignment leaves room for.
+		void write(UploadContext& uploads, uint64_t offset, std::span<const std::byte> data) const;
+
+		void reset();
+
+	private:
+		friend class DynamicBufferPool;
+
+		DynamicBuffer(DynamicBufferPool& pool, uint32_t slot) : _pool(&pool), _slot(slot) {}
+
+	private:
+		DynamicBufferPool* _pool = nullptr;
+		uint32_t		   _slot = 0;
 	};
 
+	/// Suballocating heap for one usage class. Ranges come out of large pages through a TLSF
+	/// allocator, so loading and unloading geometry creates no buffers once the pages exist and
+	/// freed ranges merge back with their neighbours.
+	///
+	/// Ranges start at multiples of `alignment`, which satisfies vertex, index, uniform and
+	/// storage offsets alike. Every page also gets `CopySrc | CopyDst` for uploads and
+	/// `compact()`.
 	class DynamicBufferPool {
 	public:
+		inline static constexpr uint64_t alignment = 256;
+
+		struct Spec {
+			wgpu::BufferUsage usage		= wgpu::BufferUsage::Vertex;
+			uint64_t		  page_size = 64 << 20;
+		};
+
+	public:
+		DynamicBufferPool(const WgpuContext& ctx, const Spec& spec) : _ctx(&ctx), _spec(spec) {}
+
+		DynamicBufferPool(const Spec& spec) : DynamicBufferPool(WgpuContext::global(), spec) {}
+
+		DynamicBufferPool(const DynamicBufferPool&)			   = delete;
+		DynamicBufferPool& operator=(const DynamicBufferPool&) = delete;
+
+		/// Pool of `usage` shared by everything rendering through `ctx`.
+		inline static auto shared(const WgpuContext& ctx, wgpu::BufferUsage usage)
+			-> DynamicBufferPool& {
+			auto&			 shared = _shared();
+			std::unique_lock lock { shared.mtx };
+			auto&			 pool =
+				shared.pools[{ ctx.device.Get(), static_cast<uint64_t>(usage) }];
+			if (!pool)
+				pool = std::make_unique<DynamicBufferPool>(ctx, Spec { .usage = usage });
+			return *pool;
+		}
+
+		inline static auto shared(wgpu::BufferUsage usage) -> DynamicBufferPool& {
+			return shared(WgpuContext::global(), usage);
+		}
+
+		/// Releases the empty pages of every shared pool, e.g. before reporting leaks.
+		inline static void trim_shared() {
+			auto&			 shared = _shared();
+			std::unique_lock lock { shared.mtx };
+			for (auto& [key, pool] : shared.pools) pool->trim();
+		}
+
+	public:
+		[[nodiscard]] auto allocate(uint64_t size) -> DynamicBuffer {
+			std::unique_lock lock { _mtx };
+			const auto		 granules = static_cast<uint32_t>((size + alignment - 1) / alignment);
+
+			auto [page, block] = _place(granules, [](uint32_t) { return true; });
+			if (page == Heap::none) {
+				page  = _add_page(std::max<uint64_t>(granules, _spec.page_size / alignment));
+				block = _pages[page]->heap.allocate(granules);
+			}
+
+			uint32_t slot;
+			if (_free_slots.empty()) {
+				slot = static_cast<uint32_t>(_slots.size());
+				_slots.emplace_back();
+			} else {
+				slot = _free_slots.back();
+				_free_slots.pop_back();
+			}
+			// Counted for the caller's scope; the page itself is only pool capacity.
+			_slots[slot] = {
+				.page	= page,
+				.block	= block,
+				.size	= size,
+				.memory = MemoryTracker::global().track(memory_category(_spec.usage), size),
+			};
+			_pages[page]->heap.block(block).owner = slot;
+			return { *this, slot };
+		}
+
+		/// Allocates `data.size()` bytes and stages `data` into them on `uploads`.
+		[[nodiscard]] auto allocate(UploadContext& uploads, std::span<const std::byte> data)
+			-> DynamicBuffer {
+			auto range = allocate(data.size());
+			range.write(uploads, 0, data);
+			return range;
+		}
+
+		/// Evacuates pages less than `threshold` full into the others, recording the moves into
+		/// `cmd`, then releases every empty page. Bumps `generation()` if anything moved; bind
+		/// groups and draws built over moved ranges have to be recreated. Returns the bytes
+		/// moved.
+		auto compact(const wgpu::CommandEncoder& cmd, float threshold = .25f) -> uint64_t {
+			std::unique_lock  lock { _mtx };
+			std::vector<bool> sparse(_pages.size());
+			for (uint32_t page = 0; page < _pages.size(); ++page)
+				sparse[page] = _pages[page]
+							&& _pages[page]->heap.used() < threshold * _pages[page]->heap.size();
+
+			const auto dense = [&](uint32_t page) { return !sparse[page]; };
+			uint64_t   moved = 0;
+			for (uint32_t page = 0; page < _pages.size(); ++page) {
+				if (!sparse[page])
+					continue;
+
+				std::vector<uint32_t> blocks;
+				_pages[page]->heap.for_each_used([&](uint32_t b, const auto&) {
+					blocks.push_back(b);
+				});
+				for (const auto b : blocks) {
+					const auto from			 = _pages[page]->heap.block(b);
+					const auto [to_page, to] = _place(from.size, dense);
+					if (to_page == Heap::none)
+						break;	// no room elsewhere, the page stays
+
+					auto& target = _pages[to_page]->heap.block(to);
+					target.owner = from.owner;
+					cmd.CopyBufferToBuffer(
+						_pages[page]->buffer,
+						uint64_t { from.offset } * alignment,
+						_pages[to_page]->buffer,
+						uint64_t { target.offset } * alignment,
+						uint64_t { from.size } * alignment
+					);
+					_slots[from.owner].page	 = to_page;
+					_slots[from.owner].block = to;
+					_pages[page]->heap.free(b);
+					moved += uint64_t { from.size } * alignment;
+				}
+			}
+			if (moved > 0)
+				++_generation;
+			_trim();
+			return moved;
+		}
+
+		/// Releases pages without live ranges.
+		void trim() {
+			std::unique_lock lock { _mtx };
+			_trim();
+		}
+
+		[[nodiscard]] auto generation() const -> uint64_t {
+			std::unique_lock lock { _mtx };
+			return _generation;
+		}
+
+		/// Bytes handed out, including the padding up to `alignment`.
+		[[nodiscard]] auto used() const -> uint64_t {
+			std::unique_lock lock { _mtx };
+			uint64_t		 used = 0;
+			for (const auto& page : _pages)
+				if (page)
+					used += uint64_t { page->heap.used() } * alignment;
+			return used;
+		}
+
+		[[nodiscard]] auto capacity() const -> uint64_t {
+			std::unique_lock lock { _mtx };
+			uint64_t		 capacity = 0;
+			for (const auto& page : _pages)
+				if (page)
+					capacity += page->buffer.GetSize();
+			return capacity;
+		}
+
+	private:
+		friend class DynamicBuffer;
+
+		using Heap = details::buffer_heap::Tlsf;
+
+		struct Shared {
+			std::mutex																	  mtx;
+			std::map<std::pair<WGPUDevice, uint64_t>, std::unique_ptr<DynamicBufferPool>> pools;
+		};
+
+		inline static auto _shared() -> Shared& {
+			static Shared shared;
+			return shared;
+		}
+
+		struct Page {
+			wgpu::Buffer			  buffer;
+			MemoryTracker::Allocation memory;
+			Heap					  heap;
+		};
+
+		struct Slot {
+			uint32_t				  page;
+			uint32_t				  block;
+			uint64_t				  size;
+			MemoryTracker::Allocation memory;
+		};
+
+		/// First page accepted by `usable` with room for `granules`.
+		template<typename F>
+		[[nodiscard]] auto _place(uint32_t granules, F&& usable) -> std::pair<uint32_t, uint32_t> {
+			for (uint32_t page = 0; page < _pages.size(); ++page)
+				if (_pages[page] && usable(page))
+					if (const auto block = _pages[page]->heap.allocate(granules);
+						block != Heap::none)
+						return { page, block };
+			return { Heap::none, Heap::none };
+		}
+
+		auto _add_page(uint64_t granules) -> uint32_t {
+			const wgpu::BufferDescriptor desc {
+				.usage = _spec.usage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst,
+				.size  = granules * alignment,
+			};
+			auto page = std::optional<Page> { Page {
+				.buffer = _ctx->device.CreateBuffer(&desc),
+				.memory = MemoryTracker::global().track_pool(
+					memory_category(_spec.usage),
+					desc.size,
+					"DynamicBufferPool"
+				),
+				.heap = Heap { static_cast<uint32_t>(granules) },
+			} };
+			if (const auto it = std::ranges::find(_pages, std::nullopt); it != _pages.end()) {
+				*it = std::move(page);
+				return static_cast<uint32_t>(it - _pages.begin());
+			}
+			_pages.push_back(std::move(page));
+			return static_cast<uint32_t>(_pages.size() - 1);
+		}
+
+		void _trim() {
+			for (auto& page : _pages)
+				if (page && page->heap.used() == 0)
+					page.reset();
+		}
+
+		void _release(uint32_t slot) {
+			std::unique_lock lock { _mtx };
+			_pages[_slots[slot].page]->heap.free(_slots[slot].block);
+			_slots[slot].memory = {};
+			_free_slots.push_back(slot);
+		}
+
+		struct Range {
+			wgpu::Buffer buffer;
+			uint64_t	 offset;
+			uint64_t	 size;
+		};
+
+		[[nodiscard]] auto _resolve(uint32_t slot) const -> Range {
+			std::unique_lock lock { _mtx };
+			const auto&		 s	  = _slots[slot];
+			const auto&		 page = *_pages[s.page];
+			return {
+				.buffer = page.buffer,
+				.offset = uint64_t { page.heap.block(s.block).offset } * alignment,
+				.size	= s.size,
+			};
+		}
+
 	private:
-		std::vector<DynamicBuffer> _buffers;
+		const WgpuContext*				 _ctx;
+		Spec							 _spec;
+		mutable std::mutex				 _mtx;
+		std::vector<std::optional<Page>> _pages;
+		std::vector<Slot>				 _slots;
+		std::vector<uint32_t>			 _free_slots;
+		uint64_t						 _generation = 0;
 	};
 
-	template<typename T, wgpu::BufferUsage usage>
-	inline auto array_buffer(const WgpuContext& ctx, std::span<const T> data) -> wgpu::Buffer {
+	inline auto DynamicBuffer::buffer() const -> wgpu::Buffer {
+		return _pool->_resolve(_slot).buffer;
+	}
+
+	inline auto DynamicBuffer::offset() const -> uint64_t { return _pool->_resolve(_slot).offset; }
+
+	inline auto DynamicBuffer::size() const -> uint64_t { return _pool->_resolve(_slot).size; }
+
+	inline void DynamicBuffer::write(
+		UploadContext& uploads, uint64_t offset, std::span<const std::byte> data
+	) const {
+		const auto range = _pool->_resolve(_slot);
+		const auto body	 = data.size() & ~size_t { 3 };
+		uploads.write(range.buffer, range.offset + offset, data.first(body));
+		if (body < data.size()) {
+			std::array<std::byte, 4> tail = {};
+			std::ranges::copy(data.subspan(body), tail.begin());
+			uploads.write(range.buffer, range.offset + offset + body, tail);
+		}
+	}
+
+	inline void DynamicBuffer::reset() {
+		if (_pool)
+			std::exchange(_pool, nullptr)->_release(_slot);
+	}
+
+	/// Creates a buffer mapped at creation and lets `fill` write its initial contents straight
+	/// into the mapped range, skipping the staging copy `WriteBuffer` makes. `size` is rounded
+	/// up to 4 bytes as mapping requires.
+	template<wgpu::BufferUsage usage, typename F>
+		requires std::invocable<F, std::span<std::byte>>
+	inline auto mapped_buffer(const WgpuContext& ctx, size_t size, F&& fill) -> TrackedBuffer {
 		const wgpu::BufferDescriptor desc {
 			.usage			  = usage,
-			.size			  = sizeof(T) * data.size(),
-			.mappedAtCreation = false,
+			.size			  = (size + 3) & ~size_t { 3 },
+			.mappedAtCreation = true,
 		};
-		wgpu::Buffer buffer = ctx.device.CreateBuffer(&desc);
+		TrackedBuffer buffer = create_buffer(ctx, desc);
 
-		ctx.queue.WriteBuffer(buffer, 0, data.data(), sizeof(T) * data.size());
+		std::forward<F>(fill)(std::span {
+			static_cast<std::byte*>(buffer.GetMappedRange(0, desc.size)),
+			static_cast<size_t>(desc.size),
+		});
+		buffer.Unmap();
 
 		return buffer;
 	}
 
+	template<wgpu::BufferUsage usage, typename F>
+		requires std::invocable<F, std::span<std::byte>>
+	inline auto mapped_buffer(size_t size, F&& fill) -> TrackedBuffer {
+		return mapped_buffer<usage>(WgpuContext::global(), size, std::forward<F>(fill));
+	}
+
+	template<typename T, wgpu::BufferUsage usage>
+	inline auto array_buffer(const WgpuContext& ctx, std::span<const T> data) -> TrackedBuffer {
+		const auto bytes = std::as_bytes(data);
+		return mapped_buffer<usage>(ctx, bytes.size(), [&](std::span<std::byte> range) {
+			std::ranges::copy(bytes, range.begin());
+		});
+	}
+
 	template<typename T, wgpu::BufferUsage usage>
-	inline auto array_buffer(std::span<const T> data) -> wgpu::Buffer {
-		return array_buffer(WgpuContext::global(), data);
+	inline auto array_buffer(std::span<const T> data) -> TrackedBuffer {
+		return array_buffer<T, usage>(WgpuContext::global(), data);
 	}
 
 	template<typename VerticeT>
 	inline auto array_vertex_buffer(const WgpuContext& ctx, std::span<const VerticeT> data)
-		-> wgpu::Buffer {
+		-> TrackedBuffer {
 		return array_buffer<VerticeT, wgpu::BufferUsage::Vertex | wgpu::BufferUsage::CopyDst>(
 			ctx,
 			data
@@ -469,18 +1020,18 @@ namespace dvdbchar::Render {
 	}
 
 	template<typename VerticeT>
-	inline auto array_vertex_buffer(std::span<const VerticeT> data) -> wgpu::Buffer {
+	inline auto array_vertex_buffer(std::span<const VerticeT> data) -> TrackedBuffer {
 		return array_vertex_buffer<VerticeT>(WgpuContext::global(), data);
 	}
 
 	template<typename T>
 	inline auto array_index_buffer(const WgpuContext& ctx, std::span<const T> data)
-		-> wgpu::Buffer {
+		-> TrackedBuffer {
 		return array_buffer<T, wgpu::BufferUsage::Index | wgpu::BufferUsage::CopyDst>(ctx, data);
 	}
 
 	template<typename T>
-	inline auto array_index_buffer(std::span<const T> data) -> wgpu::Buffer {
+	inline auto array_index_buffer(std::span<const T> data) -> TrackedBuffer {
 		return array_index_buffer<T>(WgpuContext::global(), data);
 	}
 }  // namespace dvdbchar::Render
\ No newline at end of file
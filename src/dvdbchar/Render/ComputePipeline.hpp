@@ -0,0 +1,53 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+#include "dvdbchar/Render/ShaderReflection.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <string_view>
+
+namespace dvdbchar::Render {
+	class ComputePipeline : public wgpu::ComputePipeline {
+	public:
+		struct Spec {
+			std::string_view shader;
+			std::string_view reflection;
+		};
+
+	public:
+		ComputePipeline(const WgpuContext& ctx, const Spec& spec) {
+			const wgpu::ShaderSourceWGSL	   wgsl { { .code = spec.shader } };
+
+			const wgpu::ShaderModuleDescriptor shader_module_desc = { .nextInChain = &wgsl };
+			const wgpu::ShaderModule		   shader_module =
+				ctx.device.CreateShaderModule(&shader_module_desc);
+
+			const auto bgls = parsed::bindgroup_layouts_from_string(ctx, spec.reflection);
+			const wgpu::ComputePipelineDescriptor pipeline_desc = {
+				.layout = [&](){
+					const wgpu::PipelineLayoutDescriptor desc = {
+						.bindGroupLayoutCount = bgls.size(),
+						.bindGroupLayouts = bgls.data(),
+					};
+					return ctx.device.CreatePipelineLayout(&desc);
+				}(),
+				.compute = {
+					.module = shader_module,
+				},
+			};
+			static_cast<wgpu::ComputePipeline&>(*this) =
+				ctx.device.CreateComputePipeline(&pipeline_desc);
+			_memory = MemoryTracker::global().track(MemoryCategory::pipeline, 0);
+		}
+
+		ComputePipeline(const Spec& spec) : ComputePipeline(WgpuContext::global(), spec) {}
+
+	public:
+		[[nodiscard]] auto get() const -> const wgpu::ComputePipeline& { return *this; }
+
+	private:
+		MemoryTracker::Allocation _memory;
+	};
+}  // namespace dvdbchar::Render
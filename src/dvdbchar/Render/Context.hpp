@@ -5,6 +5,7 @@
 #include <dawn/webgpu_cpp.h>
 #include <stdexec/execution.hpp>
 #include <utility>
+#include <vector>
 
 namespace dvdbchar::Render {
 	struct WgpuContext {
@@ -45,6 +46,11 @@ namespace dvdbchar::Render {
 				 );
 				 return desc;
 			}();
+			/// Enabled on top of `device_desc`'s required features when the adapter has them.
+			std::vector<wgpu::FeatureName> optional_features = {
+				wgpu::FeatureName::TextureCompressionBC,
+				wgpu::FeatureName::IndirectFirstInstance,
+			};
 		};
 
 		inline static auto create(const Spec& spec) {
@@ -68,9 +74,19 @@ namespace dvdbchar::Render {
 				),
 				std::numeric_limits<uint32_t>::max()
 			);
+			auto						   device_desc = spec.device_desc;
+			std::vector<wgpu::FeatureName> features(
+				device_desc.requiredFeatures,
+				device_desc.requiredFeatures + device_desc.requiredFeatureCount
+			);
+			for (const auto feature : spec.optional_features)
+				if (ctx.adapter.HasFeature(feature))
+					features.push_back(feature);
+			device_desc.requiredFeatureCount = features.size();
+			device_desc.requiredFeatures	 = features.data();
 			ctx.instance.WaitAny(
 				ctx.adapter.RequestDevice(
-					&spec.device_desc,
+					&device_desc,
 					wgpu::CallbackMode::WaitAnyOnly,
 					[&](wgpu::RequestDeviceStatus status,
 						wgpu::Device			  d,
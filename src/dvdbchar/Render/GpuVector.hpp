@@ -0,0 +1,107 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <algorithm>
+#include <span>
+#include <type_traits>
+
+namespace dvdbchar::Render {
+	/// Growable array living on the GPU, for append-heavy streams such as debug lines, particles
+	/// or instance data.
+	///
+	/// Capacity grows by half on overflow. Growing records a copy of the live elements into the
+	/// new buffer, so contents written by the GPU survive too. Writes are recorded into the same
+	/// `UploadContext`, which orders them after any pending migration. Growing replaces
+	/// `buffer()` and bumps `generation()`; bind groups over the old buffer have to be recreated.
+	template<typename T, wgpu::BufferUsage usage>
+		requires std::is_trivially_copyable_v<T>
+	class GpuVector {
+		static_assert(sizeof(T) % 4 == 0, "buffer copies move multiples of 4 bytes");
+
+	public:
+		inline static constexpr size_t min_capacity = 16;
+
+	public:
+		GpuVector(const WgpuContext& ctx) : _ctx(&ctx) {}
+
+		GpuVector() : GpuVector(WgpuContext::global()) {}
+
+	public:
+		[[nodiscard]] auto buffer() const -> const wgpu::Buffer& { return _buffer; }
+
+		[[nodiscard]] auto size() const -> size_t { return _size; }
+
+		[[nodiscard]] auto capacity() const -> size_t { return _capacity; }
+
+		[[nodiscard]] auto empty() const -> bool { return _size == 0; }
+
+		[[nodiscard]] auto generation() const -> uint64_t { return _generation; }
+
+		/// Binding over the live elements.
+		[[nodiscard]] auto entry(uint32_t binding) const -> wgpu::BindGroupEntry {
+			return { .binding = binding, .buffer = _buffer, .offset = 0, .size = _bytes(_size) };
+		}
+
+		/// Makes room for `capacity` elements, migrating the live ones on the GPU.
+		void reserve(UploadContext& uploads, size_t capacity) {
+			if (capacity <= _capacity)
+				return;
+			const wgpu::BufferDescriptor desc {
+				.usage = usage | wgpu::BufferUsage::CopySrc | wgpu::BufferUsage::CopyDst,
+				.size  = _bytes(capacity),
+			};
+			auto buffer = create_buffer(*_ctx, desc);
+			if (_size > 0)
+				uploads.copy(_buffer, 0, buffer, 0, _bytes(_size));
+			_buffer	  = std::move(buffer);
+			_capacity = capacity;
+			++_generation;
+		}
+
+		/// Grown elements keep what the buffer held there: zeros unless written before.
+		void resize(UploadContext& uploads, size_t size) {
+			_grow_to(uploads, size);
+			_size = size;
+		}
+
+		void push_back(UploadContext& uploads, const T& value) {
+			append(uploads, std::span { &value, 1 });
+		}
+
+		void append(UploadContext& uploads, std::span<const T> values) {
+			const auto first = _size;
+			resize(uploads, _size + values.size());
+			write(uploads, first, values);
+		}
+
+		/// Overwrites elements from `first` on, which must already be live.
+		void write(UploadContext& uploads, size_t first, std::span<const T> values) {
+			uploads.write(_buffer, _bytes(first), std::as_bytes(values));
+		}
+
+		/// Drops every element but keeps the capacity.
+		void clear() { _size = 0; }
+
+	private:
+		[[nodiscard]] inline static constexpr auto _bytes(size_t count) -> uint64_t {
+			return uint64_t { count } * sizeof(T);
+		}
+
+		void _grow_to(UploadContext& uploads, size_t size) {
+			if (size > _capacity)
+				reserve(uploads, std::max({ size, _capacity + _capacity / 2, min_capacity }));
+		}
+
+	private:
+		const WgpuContext* _ctx;
+		TrackedBuffer	   _buffer;
+		size_t			   _size	   = 0;
+		size_t			   _capacity   = 0;
+		uint64_t		   _generation = 0;
+	};
+}  // namespace dvdbchar::Render
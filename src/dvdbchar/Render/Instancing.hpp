@@ -0,0 +1,235 @@
+#pragma once
+
+#include "dvdbchar/Render/Bindgroup.hpp"
+#include "dvdbchar/Render/ComputePipeline.hpp"
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/GpuVector.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+#include "dvdbchar/Render/Mesh.hpp"
+#include "dvdbchar/Render/ShaderReflection.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <range/v3/all.hpp>
+
+#include <array>
+#include <cstddef>
+#include <format>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dvdbchar::Render {
+	/// Copy of a model placed in the world; mirrors `Instance.slang`.
+	struct Instance {
+		glm::mat4 world	   = glm::mat4(1.f);
+		uint32_t  material = 0;	   // row of the material table
+		float	  radius   = 0.f;  // bounding sphere around the model origin, 0: never culled
+		uint32_t  _pad[2]  = {};
+	};
+
+	/// Arguments of one `DrawIndexedIndirect`, as the GPU reads them.
+	struct DrawIndexedIndirectArgs {
+		uint32_t index_count;
+		uint32_t instance_count;
+		uint32_t first_index;
+		int32_t	 base_vertex;
+		uint32_t first_instance;
+	};
+
+	/// Uniform block of `Instancing.slang`.
+	struct CullingParams {
+		std::array<glm::vec4, 6> planes;
+		uint32_t				 instance_count;
+		uint32_t				 _pad[3];
+	};
+
+	/// Normalized planes of the frustum of `view_projection`, normals pointing inwards. The near
+	/// plane is OpenGL's, which only lets more through for zero-to-one depth.
+	inline auto frustum_planes(const glm::mat4& view_projection) -> std::array<glm::vec4, 6> {
+		const auto row	  = [&](int i) { return glm::row(view_projection, i); };
+		auto	   planes = std::array {
+			  row(3) + row(0), row(3) - row(0), row(3) + row(1),
+			  row(3) - row(1), row(3) + row(2), row(3) - row(2),
+		};
+		for (auto& plane : planes) plane /= glm::length(glm::vec3 { plane });
+		return planes;
+	}
+
+	/// Copies of one model drawn together, for crowds of avatars or props.
+	///
+	/// Instances and the material table they index live in storage buffers that the vertex
+	/// shader reads through the scene bind group. `cull()` tests the instances against the view
+	/// frustum on the GPU, compacts the survivors into the visible list and copies their count
+	/// into the `DrawIndexedIndirect` arguments of every draw, so the CPU records the same
+	/// commands for ten instances as for ten thousand.
+	///
+	/// Draws carry their node slot above `instance_bits` of the first instance. Indirect draws
+	/// with a non-zero first instance need `IndirectFirstInstance`; without it `indirect()` is
+	/// false and every instance is drawn directly, unculled.
+	class InstanceSet {
+	public:
+		inline static constexpr uint32_t instance_bits	= 16;
+		inline static constexpr size_t	 max_instances	= size_t { 1 } << instance_bits;
+		inline static constexpr uint32_t workgroup_size = 64;  // `numthreads` of `cullMain`
+
+	public:
+		InstanceSet(const WgpuContext& ctx) :
+			_ctx(&ctx), _indirect(ctx.device.HasFeature(wgpu::FeatureName::IndirectFirstInstance)),
+			_instances(ctx), _visible(ctx), _materials(ctx), _args(ctx) {
+			const wgpu::BufferDescriptor count_desc {
+				.usage = wgpu::BufferUsage::Storage | wgpu::BufferUsage::CopySrc
+					   | wgpu::BufferUsage::CopyDst,
+				.size = sizeof(uint32_t),
+			};
+			_count = create_buffer(ctx, count_desc);
+			const wgpu::BufferDescriptor params_desc {
+				.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
+				.size  = sizeof(CullingParams),
+			};
+			_params = create_buffer(ctx, params_desc);
+		}
+
+		InstanceSet() : InstanceSet(WgpuContext::global()) {}
+
+	public:
+		[[nodiscard]] auto size() const -> size_t { return _instances.size(); }
+
+		[[nodiscard]] auto empty() const -> bool { return _instances.empty(); }
+
+		/// Whether draws read the arguments `cull()` writes.
+		[[nodiscard]] auto indirect() const -> bool { return _indirect; }
+
+		/// Changes whenever a buffer behind `entries()` is replaced.
+		[[nodiscard]] auto generation() const -> uint64_t {
+			return _instances.generation() + _visible.generation() + _materials.generation();
+		}
+
+		/// Scene bindings of the instances, the visible list and the materials, from `first` on.
+		[[nodiscard]] auto entries(uint32_t first) const -> std::array<wgpu::BindGroupEntry, 3> {
+			return {
+				_instances.entry(first),
+				_visible.entry(first + 1),
+				_materials.entry(first + 2),
+			};
+		}
+
+		/// Indirect buffer holding one `DrawIndexedIndirectArgs` per draw of `set_draws()`.
+		[[nodiscard]] auto args() const -> const wgpu::Buffer& { return _args.buffer(); }
+
+		[[nodiscard]] inline static constexpr auto args_offset(size_t draw) -> uint64_t {
+			return draw * sizeof(DrawIndexedIndirectArgs);
+		}
+
+		/// Replaces the instances; the materials default to a single plain white one.
+		void assign(UploadContext& uploads, std::span<const Instance> instances) {
+			if (instances.empty() || instances.size() > max_instances) [[unlikely]]
+				throw std::out_of_range { std::format(
+					"{} instances requested, 1 to {} supported",
+					instances.size(),
+					max_instances
+				) };
+			_instances.clear();
+			_instances.append(uploads, instances);
+			_visible.resize(uploads, instances.size());
+			if (!_indirect) {
+				std::vector<uint32_t> all(instances.size());
+				std::iota(all.begin(), all.end(), 0u);
+				_visible.write(uploads, 0, all);
+			}
+			if (_materials.empty())
+				set_materials(uploads, std::array { glm::vec4 { 1.f } });
+		}
+
+		/// Base colour factors `Instance::material` picks from; at least one.
+		void set_materials(UploadContext& uploads, std::span<const glm::vec4> materials) {
+			_materials.clear();
+			_materials.append(uploads, materials);
+		}
+
+		/// Writes the arguments of one draw per primitive, in order. Only the instance count
+		/// changes afterwards, so call it when the primitives do.
+		void set_draws(UploadContext& uploads, std::span<const MeshPrimitive> primitives) {
+			const auto draw = [](const MeshPrimitive& primitive) {
+				return DrawIndexedIndirectArgs {
+					.index_count	= static_cast<uint32_t>(primitive.buf_index_count),
+					.instance_count = 0,
+					.first_index	= primitive.first_index,
+					.base_vertex	= primitive.base_vertex,
+					.first_instance = primitive.instance << instance_bits,
+				};
+			};
+			const auto args =
+				primitives | ranges::views::transform(draw) | ranges::to<std::vector>();
+			_args.clear();
+			_args.append(uploads, args);
+		}
+
+		/// Culls the instances against `view_projection` and hands the survivor count to every
+		/// draw. Record it outside of any pass, ahead of the passes drawing the instances.
+		void cull(
+			UploadContext& uploads, const wgpu::CommandEncoder& cmd,
+			const ComputePipeline& pipeline, const glm::mat4& view_projection
+		) {
+			if (!_indirect || empty() || _args.empty())
+				return;
+
+			const CullingParams params {
+				.planes			= frustum_planes(view_projection),
+				.instance_count = static_cast<uint32_t>(size()),
+			};
+			uploads.write(_params, 0, std::as_bytes(std::span { &params, 1 }));
+			if (const auto generation = _instances.generation() + _visible.generation();
+				std::exchange(_culling_generation, generation) != generation)
+				_bg_culling = _make_culling_bindgroup();
+
+			cmd.ClearBuffer(_count, 0, sizeof(uint32_t));
+			const auto pass = cmd.BeginComputePass();
+			pass.SetPipeline(pipeline);
+			pass.SetBindGroup(0, _bg_culling);
+			pass.DispatchWorkgroups((params.instance_count + workgroup_size - 1) / workgroup_size);
+			pass.End();
+
+			for (size_t draw = 0; draw < _args.size(); ++draw)
+				cmd.CopyBufferToBuffer(
+					_count,
+					0,
+					_args.buffer(),
+					args_offset(draw) + offsetof(DrawIndexedIndirectArgs, instance_count),
+					sizeof(uint32_t)
+				);
+		}
+
+	private:
+		[[nodiscard]] auto _make_culling_bindgroup() const -> wgpu::BindGroup {
+			const auto layout = parsed::bindgroup_layout_from_path(
+				*_ctx,
+				"culling",
+				"shaders/Instancing.layout.json"
+			);
+			const auto entries = std::array {
+				wgpu::BindGroupEntry { .binding = 0, .buffer = _params },
+				_instances.entry(1),
+				_visible.entry(2),
+				wgpu::BindGroupEntry { .binding = 3, .buffer = _count },
+			};
+			return Bindgroup { *_ctx, { .layout = layout, .entries = entries } };
+		}
+
+	private:
+		const WgpuContext*												_ctx;
+		bool															_indirect;
+		GpuVector<Instance, wgpu::BufferUsage::Storage>					_instances;
+		GpuVector<uint32_t, wgpu::BufferUsage::Storage>					_visible;
+		GpuVector<glm::vec4, wgpu::BufferUsage::Storage>				_materials;
+		GpuVector<DrawIndexedIndirectArgs, wgpu::BufferUsage::Indirect>	_args;
+		TrackedBuffer													_count;
+		TrackedBuffer													_params;
+		wgpu::BindGroup													_bg_culling;
+		uint64_t														_culling_generation = 0;
+	};
+}  // namespace dvdbchar::Render
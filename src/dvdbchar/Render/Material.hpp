@@ -19,4 +19,12 @@ namespace dvdbchar::Render {
 				| ranges::to<std::vector>();
 		}
 	};
+
+	/// GPU side of one glTF material. Handles are shared by every primitive using the material, so
+	/// comparing `bg_pbr.Get()` is enough to spot a redundant `SetBindGroup`.
+	struct PbrMaterial {
+		wgpu::Texture	tex_albedo;
+		wgpu::Sampler	smp_albedo;
+		wgpu::BindGroup bg_pbr;
+	};
 }  // namespace dvdbchar::Render
\ No newline at end of file
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dvdbchar::Render {
+	enum class MemoryCategory : uint8_t {
+		vertex,
+		index,
+		uniform,
+		storage,
+		indirect,
+		staging,
+		readback,
+		texture,
+		render_target,
+		pipeline,  // counted only, WebGPU reports no size
+	};
+
+	inline constexpr size_t memory_category_count = 10;
+
+	inline constexpr auto to_string(MemoryCategory category) -> std::string_view {
+		constexpr std::array<std::string_view, memory_category_count> names {
+			"vertex",  "index",	  "uniform", "storage",		  "indirect",
+			"staging", "readback", "texture", "render target", "pipeline",
+		};
+		return names[static_cast<size_t>(category)];
+	}
+
+	/// Category of a buffer, by the first of its usages that tells what it is for.
+	inline auto memory_category(wgpu::BufferUsage usage) -> MemoryCategory {
+		const auto has = [&](wgpu::BufferUsage flag) { return (usage & flag) == flag; };
+		if (has(wgpu::BufferUsage::MapRead))
+			return MemoryCategory::readback;
+		if (has(wgpu::BufferUsage::MapWrite))
+			return MemoryCategory::staging;
+		if (has(wgpu::BufferUsage::Indirect))
+			return MemoryCategory::indirect;
+		if (has(wgpu::BufferUsage::Index))
+			return MemoryCategory::index;
+		if (has(wgpu::BufferUsage::Vertex))
+			return MemoryCategory::vertex;
+		if (has(wgpu::BufferUsage::Uniform))
+			return MemoryCategory::uniform;
+		return MemoryCategory::storage;
+	}
+
+	inline auto memory_category(wgpu::TextureUsage usage) -> MemoryCategory {
+		constexpr auto attachment = wgpu::TextureUsage::RenderAttachment;
+		return (usage & attachment) == attachment ? MemoryCategory::render_target
+												  : MemoryCategory::texture;
+	}
+
+	/// Bytes of the mip chain `desc` asks for. Formats this renderer never creates count four
+	/// bytes per texel.
+	inline auto texture_bytes(const wgpu::TextureDescriptor& desc) -> uint64_t {
+		const auto [block, block_bytes] = [&]() -> std::pair<uint32_t, uint32_t> {
+			switch (desc.format) {
+				case wgpu::TextureFormat::BC7RGBAUnorm:
+				case wgpu::TextureFormat::BC7RGBAUnormSrgb: return { 4, 16 };
+				case wgpu::TextureFormat::R8Unorm: return { 1, 1 };
+				case wgpu::TextureFormat::RG8Unorm: return { 1, 2 };
+				case wgpu::TextureFormat::RGBA16Float: return { 1, 8 };
+				case wgpu::TextureFormat::RGBA32Float: return { 1, 16 };
+				default: return { 1, 4 };
+			}
+		}();
+
+		uint64_t bytes = 0;
+		for (uint32_t level = 0; level < desc.mipLevelCount; ++level) {
+			const auto width   = std::max(desc.size.width >> level, 1u);
+			const auto height  = std::max(desc.size.height >> level, 1u);
+			bytes			  += uint64_t { (width + block - 1) / block }
+							   * ((height + block - 1) / block) * block_bytes;
+		}
+		return bytes * desc.size.depthOrArrayLayers * desc.sampleCount;
+	}
+
+	namespace details::memory_tracker {
+		inline auto readable(uint64_t bytes) -> std::string {
+			if (bytes < 1 << 20)
+				return std::format("{:.1f} KiB", static_cast<double>(bytes) / (1 << 10));
+			return std::format("{:.1f} MiB", static_cast<double>(bytes) / (1 << 20));
+		}
+	}  // namespace details::memory_tracker
+
+	/// Bytes of GPU memory held through the `Render::` wrappers, per category and per owner,
+	/// with high-water marks.
+	///
+	/// `create_buffer()` and `create_texture()` pair each handle with an `Allocation`, which
+	/// counts until its last copy is gone. Plain `wgpu::` handles sliced off a tracked one do not
+	/// keep it alive, so keep the tracked type wherever a resource is owned. The owner is the
+	/// innermost `Scope` open on the creating thread, such as a model or a pass. Sizes are what
+	/// the descriptors ask for; the driver's padding comes on top.
+	///
+	/// Suballocating pools count each range they hand out as an allocation of its owner, and
+	/// their backing buffers through `track_pool()`, which only adds to `pooled()`.
+	class MemoryTracker {
+	public:
+		struct Usage {
+			uint64_t bytes = 0;
+			uint64_t peak  = 0;	 // high-water mark of `bytes`
+			uint32_t count = 0;	 // live allocations
+		};
+
+		struct Record {
+			MemoryCategory category;
+			uint64_t	   bytes;
+			std::string	   owner;
+			std::string	   label;
+			bool		   pooled = false;	// capacity of a pool, in `pooled()` only
+		};
+
+		/// Keeps one allocation counted; copies share it.
+		class Allocation {
+		public:
+			Allocation() = default;
+
+		public:
+			explicit operator bool() const { return _entry != nullptr; }
+
+			[[nodiscard]] auto record() const -> const Record& { return _entry->record; }
+
+		private:
+			friend class MemoryTracker;
+
+			struct Entry {
+				MemoryTracker* tracker;
+				uint64_t	   id;
+				Record		   record;
+
+				~Entry();
+			};
+
+			Allocation(std::shared_ptr<const Entry> entry) : _entry(std::move(entry)) {}
+
+		private:
+			std::shared_ptr<const Entry> _entry;
+		};
+
+		/// Attributes the allocations made on this thread to `owner` while alive. Scopes nest.
+		class Scope {
+		public:
+			explicit Scope(std::string owner) { _owners().push_back(std::move(owner)); }
+
+			~Scope() { _owners().pop_back(); }
+
+			Scope(const Scope&)			   = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		public:
+			[[nodiscard]] inline static auto current() -> std::string_view {
+				return _owners().empty() ? std::string_view { "unowned" } : _owners().back();
+			}
+
+		private:
+			inline static auto _owners() -> std::vector<std::string>& {
+				thread_local std::vector<std::string> owners;
+				return owners;
+			}
+		};
+
+	public:
+		/// Never destroyed: statics holding allocations still release into it during exit.
+		inline static auto global() -> MemoryTracker& {
+			static auto* tracker = new MemoryTracker;
+			return *tracker;
+		}
+
+	public:
+		[[nodiscard]] auto track(
+			MemoryCategory category, uint64_t bytes, std::string_view label = {}
+		) -> Allocation {
+			return _track({
+				.category = category,
+				.bytes	  = bytes,
+				.owner	  = std::string { Scope::current() },
+				.label	  = std::string { label },
+			});
+		}
+
+		/// Counts a buffer a pool suballocates from; its ranges are tracked on their own.
+		[[nodiscard]] auto track_pool(
+			MemoryCategory category, uint64_t bytes, std::string_view label = {}
+		) -> Allocation {
+			return _track({
+				.category = category,
+				.bytes	  = bytes,
+				.owner	  = "pool",
+				.label	  = std::string { label },
+				.pooled	  = true,
+			});
+		}
+
+		[[nodiscard]] auto total() const -> Usage {
+			std::unique_lock lock { _mtx };
+			return _total;
+		}
+
+		[[nodiscard]] auto usage(MemoryCategory category) const -> Usage {
+			std::unique_lock lock { _mtx };
+			return _categories[static_cast<size_t>(category)];
+		}
+
+		/// Capacity of the pools' backing buffers, whether handed out or not.
+		[[nodiscard]] auto pooled() const -> Usage {
+			std::unique_lock lock { _mtx };
+			return _pooled;
+		}
+
+		/// Every owner that ever allocated, including those holding nothing anymore.
+		[[nodiscard]] auto owners() const -> std::map<std::string, Usage, std::less<>> {
+			std::unique_lock lock { _mtx };
+			return _owners;
+		}
+
+		/// Allocations still counted, oldest first.
+		[[nodiscard]] auto live() const -> std::vector<Record> {
+			std::unique_lock	lock { _mtx };
+			std::vector<Record> records;
+			records.reserve(_live.size());
+			for (const auto& [id, record] : _live) records.push_back(*record);
+			return records;
+		}
+
+		/// Logs the live bytes and high-water marks, in total, per category and per owner, then
+		/// the capacity of the pools.
+		void report() const {
+			using details::memory_tracker::readable;
+
+			const auto log = [](std::string_view name, const Usage& usage) {
+				spdlog::info(
+					"  {:<24} {:>12} in {:>5} allocations, peak {:>12}",
+					name,
+					readable(usage.bytes),
+					usage.count,
+					readable(usage.peak)
+				);
+			};
+
+			std::unique_lock lock { _mtx };
+			spdlog::info("GPU memory:");
+			log("total", _total);
+			for (size_t i = 0; i < memory_category_count; ++i)
+				if (_categories[i].peak > 0 || _categories[i].count > 0)
+					log(to_string(static_cast<MemoryCategory>(i)), _categories[i]);
+			spdlog::info("GPU memory by owner:");
+			for (const auto& [owner, usage] : _owners) log(owner, usage);
+			if (_pooled.peak > 0)
+				log("pool capacity", _pooled);
+		}
+
+		/// Warns about every allocation still counted. Call at shutdown, once everything that
+		/// renders is gone; returns how many were left.
+		auto report_leaks() const -> size_t {
+			const auto records = live();
+			for (const auto& record : records)
+				spdlog::warn(
+					"GPU memory leaked: {} of {}{} held by `{}`",
+					details::memory_tracker::readable(record.bytes),
+					to_string(record.category),
+					record.label.empty() ? "" : std::format(" `{}`", record.label),
+					record.owner
+				);
+			return records.size();
+		}
+
+	private:
+		MemoryTracker() = default;
+
+		auto _track(Record record) -> Allocation {
+			std::unique_lock lock { _mtx };
+			auto			 entry = std::shared_ptr<const Allocation::Entry> {
+				new Allocation::Entry {
+					.tracker = this,
+					.id		 = _next_id++,
+					.record	 = std::move(record),
+				},
+			};
+			const auto& counted = entry->record;
+			_live.emplace(entry->id, &counted);
+			if (counted.pooled) {
+				_add(_pooled, counted.bytes);
+			} else {
+				_add(_total, counted.bytes);
+				_add(_categories[static_cast<size_t>(counted.category)], counted.bytes);
+				_add(_owners[counted.owner], counted.bytes);
+			}
+			return { std::move(entry) };
+		}
+
+		inline static void _add(Usage& usage, uint64_t bytes) {
+			usage.bytes += bytes;
+			usage.peak	 = std::max(usage.peak, usage.bytes);
+			++usage.count;
+		}
+
+		inline static void _sub(Usage& usage, uint64_t bytes) {
+			usage.bytes -= bytes;
+			--usage.count;
+		}
+
+		void _release(uint64_t id, const Record& record) {
+			std::unique_lock lock { _mtx };
+			_live.erase(id);
+			if (record.pooled) {
+				_sub(_pooled, record.bytes);
+				return;
+			}
+			_sub(_total, record.bytes);
+			_sub(_categories[static_cast<size_t>(record.category)], record.bytes);
+			_sub(_owners.find(record.owner)->second, record.bytes);
+		}
+
+	private:
+		mutable std::mutex						  _mtx;
+		uint64_t								  _next_id = 0;
+		Usage									  _total;
+		std::array<Usage, memory_category_count>  _categories;
+		Usage									  _pooled;
+		std::map<std::string, Usage, std::less<>> _owners;
+		std::map<uint64_t, const Record*>		  _live;  // by id, so in creation order
+	};
+
+	inline MemoryTracker::Allocation::Entry::~Entry() { tracker->_release(id, record); }
+
+	/// `wgpu` handle carrying the `MemoryTracker::Allocation` of the resource it points to.
+	template<typename Handle>
+	class Tracked : public Handle {
+	public:
+		Tracked() = default;
+
+		Tracked(Handle handle, MemoryTracker::Allocation memory) :
+			Handle(std::move(handle)), _memory(std::move(memory)) {}
+
+	public:
+		[[nodiscard]] auto memory() const -> const MemoryTracker::Allocation& { return _memory; }
+
+	private:
+		MemoryTracker::Allocation _memory;
+	};
+
+	using TrackedBuffer	 = Tracked<wgpu::Buffer>;
+	using TrackedTexture = Tracked<wgpu::Texture>;
+
+	inline auto create_buffer(const wgpu::Device& device, const wgpu::BufferDescriptor& desc)
+		-> TrackedBuffer {
+		return {
+			device.CreateBuffer(&desc),
+			MemoryTracker::global().track(
+				memory_category(desc.usage),
+				desc.size,
+				std::string_view(desc.label)
+			),
+		};
+	}
+
+	inline auto create_buffer(const WgpuContext& ctx, const wgpu::BufferDescriptor& desc)
+		-> TrackedBuffer {
+		return create_buffer(ctx.device, desc);
+	}
+
+	inline auto create_texture(const WgpuContext& ctx, const wgpu::TextureDescriptor& desc)
+		-> TrackedTexture {
+		return {
+			ctx.device.CreateTexture(&desc),
+			MemoryTracker::global().track(
+				memory_category(desc.usage),
+				texture_bytes(desc),
+				std::string_view(desc.label)
+			),
+		};
+	}
+}  // namespace dvdbchar::Render
@@ -7,13 +7,71 @@
 namespace dvdbchar::Render {
 	struct MeshPrimitive {
 		wgpu::Buffer			 buf_vertex;
+		uint64_t				 buf_vertex_offset = 0;
 		wgpu::VertexBufferLayout buf_vertex_layout = Render::vertex_layout<Vertice>();
 		wgpu::Buffer			 buf_index;
 		size_t					 buf_index_count  = 0;
 		wgpu::IndexFormat		 buf_index_format = wgpu::IndexFormat::Uint32;
+		uint32_t				 first_index	  = 0;	// in units of `buf_index_format`
+		int32_t					 base_vertex	  = 0;
+		uint32_t				 instance		  = 0;	// world matrix slot in the model's scene
 
+		size_t					 material = 0;
 		wgpu::BindGroup			 bg_pbr;
-		wgpu::Buffer			 buf_pbr;
-		wgpu::Texture			 tex_albedo;
+	};
+
+	/// Uniform block of `Skinning.slang`.
+	struct SkinningParams {
+		uint32_t first_vertex;
+		uint32_t output_vertex;	 // where the deformed `first_vertex` goes
+		uint32_t vertex_count;
+		uint32_t first_joint;	 // ~0: not skinned, only morphed
+		uint32_t vertex_stride;	 // in 32-bit words
+		uint32_t normal_offset;	 // in 32-bit words
+		uint32_t normal_format;	 // 0: float32x3, 1: snorm16x4, 2: snorm8x4
+		uint32_t morphed;
+	};
+
+	/// Parameters skinning `vertex_count` vertices of layout `VerticeT` from `first_vertex` on,
+	/// writing them from `output_vertex` on.
+	template<typename VerticeT>
+	inline constexpr auto skinning_params(
+		uint32_t first_vertex, uint32_t output_vertex, uint32_t vertex_count, uint32_t first_joint,
+		bool morphed
+	) -> SkinningParams {
+		constexpr auto normal = VerticeT::vertex_attribute()[1];
+		static_assert(sizeof(VerticeT) % 4 == 0 && normal.offset % 4 == 0);
+
+		return {
+			.first_vertex  = first_vertex,
+			.output_vertex = output_vertex,
+			.vertex_count  = vertex_count,
+			.first_joint   = first_joint,
+			.vertex_stride = sizeof(VerticeT) / 4,
+			.normal_offset = static_cast<uint32_t>(normal.offset / 4),
+			.normal_format = normal.format == wgpu::VertexFormat::Snorm16x4 ? 1u
+						   : normal.format == wgpu::VertexFormat::Snorm8x4	? 2u
+																			: 0u,
+			.morphed	   = morphed,
+		};
+	}
+
+	/// Vertex range skinned by one compute dispatch per frame.
+	struct SkinnedMesh {
+		uint32_t		vertex_count = 0;
+		wgpu::BindGroup bg_skinning;
+	};
+
+	/// Uniform block of `Morph.slang`.
+	struct MorphParams {
+		uint32_t first_delta;
+		uint32_t delta_count;
+		uint32_t target;
+	};
+
+	/// Morph target with a non-zero weight, accumulated by one compute dispatch per frame.
+	struct MorphTarget {
+		uint32_t		delta_count = 0;
+		wgpu::BindGroup bg_morph;
 	};
 }  // namespace dvdbchar::Render
\ No newline at end of file
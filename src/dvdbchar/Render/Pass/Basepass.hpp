@@ -1,6 +1,7 @@
 #pragma once
 
 #include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/Instancing.hpp"
 #include "dvdbchar/Render/Mesh.hpp"
 #include "dvdbchar/Render/Texture.hpp"
 
@@ -9,29 +10,107 @@
 
 namespace dvdbchar::Render::Pass {
 	struct BasePass {
+		inline static constexpr uint32_t no_dynamic_offset = ~0u;
+
 		TextureWrite tex_target;
 		TextureWrite tex_depth;
 
 		struct Executable {
+			/// Handles last set on the pass; bindings equal to these are skipped.
+			struct Bound {
+				WGPURenderPipeline			 pipeline		 = nullptr;
+				WGPUBuffer					 vertex_buffer	 = nullptr;
+				uint64_t					 vertex_offset	 = 0;
+				WGPUBuffer					 index_buffer	 = nullptr;
+				wgpu::IndexFormat			 index_format	 = wgpu::IndexFormat::Undefined;
+				std::array<WGPUBindGroup, 4> bindgroups		 = {};
+				std::array<uint32_t, 4>		 dynamic_offsets = {};
+			};
+
 			wgpu::CommandEncoder&	cmd;
 			wgpu::RenderPassEncoder pass;
+			Bound					bound = {};
 
-			//
+			/// `dynamic_offsets[i]` is the offset of group `i` if its layout has a dynamic uniform
+			/// binding, `no_dynamic_offset` or missing otherwise. A group that stays bound only
+			/// has its offset updated.
 			auto execute(
 				const MeshPrimitive& mesh, const Pipeline& pipeline,
-				const std::vector<wgpu::BindGroup>& bindgroups
-			) const {
-				pass.SetVertexBuffer(0, mesh.buf_vertex);
-				pass.SetIndexBuffer(mesh.buf_index, mesh.buf_index_format);
-				pass.SetPipeline(pipeline);
-				for (auto [i, bg] : ranges::views::enumerate(bindgroups)) pass.SetBindGroup(i, bg);
-				pass.DrawIndexed(mesh.buf_index_count);
+				const std::vector<wgpu::BindGroup>& bindgroups,
+				std::span<const uint32_t>			dynamic_offsets = {}
+			) {
+				_bind(mesh, pipeline, bindgroups, dynamic_offsets);
+				pass.DrawIndexed(
+					mesh.buf_index_count,
+					1,
+					mesh.first_index,
+					mesh.base_vertex,
+					mesh.instance << InstanceSet::instance_bits
+				);
+			}
+
+			/// Draws `mesh`, draw `draw` of `instances.set_draws()`, once per visible instance.
+			auto execute(
+				const MeshPrimitive& mesh, const InstanceSet& instances, size_t draw,
+				const Pipeline& pipeline, const std::vector<wgpu::BindGroup>& bindgroups,
+				std::span<const uint32_t> dynamic_offsets = {}
+			) {
+				_bind(mesh, pipeline, bindgroups, dynamic_offsets);
+				if (instances.indirect())
+					pass.DrawIndexedIndirect(instances.args(), InstanceSet::args_offset(draw));
+				else
+					pass.DrawIndexed(
+						mesh.buf_index_count,
+						instances.size(),
+						mesh.first_index,
+						mesh.base_vertex,
+						mesh.instance << InstanceSet::instance_bits
+					);
 			}
 
 			[[nodiscard]] auto end() const {
 				pass.End();
 				return cmd.Finish();
 			}
+
+		private:
+			void _bind(
+				const MeshPrimitive& mesh, const Pipeline& pipeline,
+				const std::vector<wgpu::BindGroup>& bindgroups,
+				std::span<const uint32_t>			dynamic_offsets
+			) {
+				const bool vertex_buffer_changed =
+					std::exchange(bound.vertex_buffer, mesh.buf_vertex.Get())
+					!= mesh.buf_vertex.Get();
+				const bool vertex_offset_changed =
+					std::exchange(bound.vertex_offset, mesh.buf_vertex_offset)
+					!= mesh.buf_vertex_offset;
+				if (vertex_buffer_changed || vertex_offset_changed)
+					pass.SetVertexBuffer(0, mesh.buf_vertex, mesh.buf_vertex_offset);
+				const bool index_buffer_changed =
+					std::exchange(bound.index_buffer, mesh.buf_index.Get()) != mesh.buf_index.Get();
+				const bool index_format_changed =
+					std::exchange(bound.index_format, mesh.buf_index_format)
+					!= mesh.buf_index_format;
+				if (index_buffer_changed || index_format_changed)
+					pass.SetIndexBuffer(mesh.buf_index, mesh.buf_index_format);
+				if (std::exchange(bound.pipeline, pipeline.Get()) != pipeline.Get())
+					pass.SetPipeline(pipeline);
+				for (auto [i, bg] : ranges::views::enumerate(bindgroups)) {
+					const auto offset =
+						i < dynamic_offsets.size() ? dynamic_offsets[i] : no_dynamic_offset;
+					const bool dynamic = offset != no_dynamic_offset;
+					if (i < bound.bindgroups.size()) {
+						const bool same_group =
+							std::exchange(bound.bindgroups[i], bg.Get()) == bg.Get();
+						const bool same_offset =
+							std::exchange(bound.dynamic_offsets[i], offset) == offset;
+						if (same_group && same_offset)
+							continue;
+					}
+					pass.SetBindGroup(i, bg, dynamic ? 1 : 0, dynamic ? &offset : nullptr);
+				}
+			}
 		};
 
 		auto start(wgpu::CommandEncoder& cmd) const -> Executable {
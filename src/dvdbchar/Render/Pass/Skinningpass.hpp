@@ -0,0 +1,49 @@
+#pragma once
+
+#include "dvdbchar/Render/ComputePipeline.hpp"
+#include "dvdbchar/Render/Mesh.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace dvdbchar::Render::Pass {
+	/// Morphing and linear blend skinning on the GPU. Record it before the passes drawing the
+	/// skinned vertices; within it, every morph target before the skinned meshes.
+	struct SkinningPass {
+		inline static constexpr uint32_t workgroup_size = 64;  // `numthreads` of both kernels
+
+		wgpu::Buffer buf_morph_offsets;	 // cleared before the morph targets accumulate
+
+		struct Executable {
+			wgpu::CommandEncoder&	 cmd;
+			wgpu::ComputePassEncoder pass;
+			WGPUComputePipeline		 bound_pipeline = nullptr;
+
+			//
+			auto execute(const MorphTarget& target, const ComputePipeline& pipeline) {
+				_dispatch(pipeline, target.bg_morph, target.delta_count);
+			}
+
+			auto execute(const SkinnedMesh& mesh, const ComputePipeline& pipeline) {
+				_dispatch(pipeline, mesh.bg_skinning, mesh.vertex_count);
+			}
+
+			void end() const { pass.End(); }
+
+		private:
+			void _dispatch(
+				const ComputePipeline& pipeline, const wgpu::BindGroup& bindgroup, uint32_t threads
+			) {
+				if (std::exchange(bound_pipeline, pipeline.Get()) != pipeline.Get())
+					pass.SetPipeline(pipeline);
+				pass.SetBindGroup(0, bindgroup);
+				pass.DispatchWorkgroups((threads + workgroup_size - 1) / workgroup_size);
+			}
+		};
+
+		auto start(wgpu::CommandEncoder& cmd) const -> Executable {
+			if (buf_morph_offsets)
+				cmd.ClearBuffer(buf_morph_offsets);
+			return { cmd, cmd.BeginComputePass() };
+		}
+	};
+}  // namespace dvdbchar::Render::Pass
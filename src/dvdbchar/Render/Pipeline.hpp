@@ -2,6 +2,7 @@
 
 #include "ShaderReflection.hpp"
 #include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
 #include "dvdbchar/Render/Bindgroup.hpp"
 #include "dvdbchar/Utils.hpp"
 #include "webgpu/webgpu_cpp.h"
@@ -9,42 +10,147 @@
 #include <dawn/webgpu_cpp.h>
 #include <cstddef>
 #include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/gtc/type_precision.hpp>
 
 #include <span>
 
 namespace dvdbchar::Render {
-	struct Vertice {
+	/// Storage and encoding of one vertex attribute in format `F`. `encode` takes the attribute's
+	/// natural value: `glm::vec3` for normals, `glm::vec2` for uvs, `uint32_t` for ids.
+	template<wgpu::VertexFormat F>
+	struct VertexComponent;
+
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Float32x3> {
+		using type = glm::vec3;
+
+		inline static constexpr auto encode(const glm::vec3& v) noexcept -> type { return v; }
+	};
+
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Float32x2> {
+		using type = glm::vec2;
+
+		inline static constexpr auto encode(const glm::vec2& v) noexcept -> type { return v; }
+	};
+
+	/// Unit vectors; the 4th component is padding.
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Snorm16x4> {
+		using type = glm::i16vec4;
+
+		inline static auto encode(const glm::vec3& v) noexcept -> type {
+			return type { glm::round(glm::clamp(v, -1.f, 1.f) * 32767.f), 0 };
+		}
+	};
+
+	/// Unit vectors; the 4th component is padding.
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Snorm8x4> {
+		using type = glm::i8vec4;
+
+		inline static auto encode(const glm::vec3& v) noexcept -> type {
+			return type { glm::round(glm::clamp(v, -1.f, 1.f) * 127.f), 0 };
+		}
+	};
+
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Float16x2> {
+		using type = glm::u16vec2;
+
+		inline static auto encode(const glm::vec2& v) noexcept -> type {
+			return type { glm::packHalf1x16(v.x), glm::packHalf1x16(v.y) };
+		}
+	};
+
+	/// Only for uvs inside [0, 1]; wrapping uvs are clamped.
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Unorm16x2> {
+		using type = glm::u16vec2;
+
+		inline static auto encode(const glm::vec2& v) noexcept -> type {
+			return type { glm::round(glm::clamp(v, 0.f, 1.f) * 65535.f) };
+		}
+	};
+
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Uint32> {
+		using type = uint32_t;
+
+		inline static constexpr auto encode(uint32_t v) noexcept -> type { return v; }
+	};
+
+	/// Ids below 65536; the 2nd component is padding.
+	template<>
+	struct VertexComponent<wgpu::VertexFormat::Uint16x2> {
+		using type = glm::u16vec2;
+
+		inline static constexpr auto encode(uint32_t v) noexcept -> type {
+			return type { static_cast<uint16_t>(v), 0 };
+		}
+	};
+
+	/// Mesh vertex with full precision positions and a chosen format for every other attribute.
+	/// Shaders keep declaring `float3 normal`, `float2 uv` and `uint tex_id`: wgpu converts
+	/// normalized and half formats to floats when fetching.
+	template<wgpu::VertexFormat NormalF, wgpu::VertexFormat UvF, wgpu::VertexFormat TexIdF>
+	struct BasicVertice {
+		using Normal = VertexComponent<NormalF>;
+		using Uv	 = VertexComponent<UvF>;
+		using TexId	 = VertexComponent<TexIdF>;
+
 		glm::vec3					 pos;
-		glm::vec3					 normal;
-		glm::vec2					 uv;
-		size_t						 tex_id;
+		typename Normal::type		 normal;
+		typename Uv::type			 uv;
+		typename TexId::type		 tex_id;
 
 		inline static constexpr auto vertex_attribute() noexcept {
 			return std::to_array<wgpu::VertexAttribute>({
 				{
 					.format			= wgpu::VertexFormat::Float32x3,
-					.offset			= offsetof(Vertice,	pos),
+					.offset			= offsetof(BasicVertice,	pos),
 					.shaderLocation = 0,
 				 },
 				{
-					.format			= wgpu::VertexFormat::Float32x3,
-					.offset			= offsetof(Vertice, normal),
+					.format			= NormalF,
+					.offset			= offsetof(BasicVertice, normal),
 					.shaderLocation = 1,
 				 },
 				{
-					.format			= wgpu::VertexFormat::Float32x2,
-					.offset			= offsetof(Vertice,		uv),
+					.format			= UvF,
+					.offset			= offsetof(BasicVertice,		uv),
 					.shaderLocation = 2,
 				 },
 				{
-					.format			= wgpu::VertexFormat::Uint32,
-					.offset			= offsetof(Vertice, tex_id),
+					.format			= TexIdF,
+					.offset			= offsetof(BasicVertice, tex_id),
 					.shaderLocation = 3,
 				 },
 			});
 		}
 	};
 
+	using FullVertice = BasicVertice<
+		wgpu::VertexFormat::Float32x3,
+		wgpu::VertexFormat::Float32x2,
+		wgpu::VertexFormat::Uint32>;
+	using CompactVertice = BasicVertice<
+		wgpu::VertexFormat::Snorm16x4,
+		wgpu::VertexFormat::Float16x2,
+		wgpu::VertexFormat::Uint16x2>;
+	using PackedVertice = BasicVertice<
+		wgpu::VertexFormat::Snorm8x4,
+		wgpu::VertexFormat::Unorm16x2,
+		wgpu::VertexFormat::Uint16x2>;
+
+	static_assert(sizeof(FullVertice) == 36);
+	static_assert(sizeof(CompactVertice) == 28);
+	static_assert(sizeof(PackedVertice) == 24);
+
+	/// The layout models are baked, uploaded and drawn with.
+	using Vertice = CompactVertice;
+
 	template<typename T>
 		requires requires {
 			{ T::vertex_attribute() } -> FatPointerAlike;
@@ -72,15 +178,16 @@ namespace dvdbchar::Render {
 		};
 
 		struct Spec {
-			std::string_view	shader;
-			std::string_view	reflection;
-			wgpu::TextureFormat format;
-			VertexInfo			vertex = []() -> VertexInfo {
-				 static auto default_attrib = Vertice::vertex_attribute();
-				 return {
-							 .stride	 = sizeof(Vertice),
-							 .attributes = default_attrib,
-				 };
+			std::string_view		  shader;
+			std::string_view		  reflection;
+			std::span<const uint32_t> dynamic_offsets;	// groups bound with a dynamic offset
+			wgpu::TextureFormat		  format;
+			VertexInfo				  vertex = []() -> VertexInfo {
+				   static auto default_attrib = Vertice::vertex_attribute();
+				   return {
+							   .stride	   = sizeof(Vertice),
+							   .attributes = default_attrib,
+				   };
 			}();
 		};
 
@@ -124,7 +231,8 @@ namespace dvdbchar::Render {
 				.attributeCount = spec.vertex.attributes.size(),
 				.attributes		= spec.vertex.attributes.data(),
 			};
-			const auto bgls = parsed::bindgroup_layouts_from_string(ctx, spec.reflection);
+			const auto bgls =
+				parsed::bindgroup_layouts_from_string(ctx, spec.reflection, spec.dynamic_offsets);
 			const wgpu::DepthStencilState depth_stencil_state {
 				.format			   = wgpu::TextureFormat::Depth24Plus,
 				.depthWriteEnabled = true,
@@ -151,6 +259,7 @@ namespace dvdbchar::Render {
 			};
 			static_cast<wgpu::RenderPipeline&>(*this) =
 				ctx.device.CreateRenderPipeline(&pipeline_desc);
+			_memory = MemoryTracker::global().track(MemoryCategory::pipeline, 0);
 		}
 
 		Pipeline(
@@ -165,5 +274,8 @@ namespace dvdbchar::Render {
 
 	public:
 		[[nodiscard]] auto get() const -> const wgpu::RenderPipeline& { return *this; }
+
+	private:
+		MemoryTracker::Allocation _memory;
 	};
 }  // namespace dvdbchar::Render
\ No newline at end of file
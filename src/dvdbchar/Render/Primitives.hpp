@@ -99,32 +99,17 @@ namespace dvdbchar::Render {
 		}
 	};
 
-	struct ModelDataRefl {
-		Field<glm::mat4x4> model_matrix;
-	};
-
-	template<>
-	struct ReflectionRegistry<ModelDataRefl> {
-		inline static consteval auto mapping() {
-			return std::make_tuple(	 //
-				std::pair { "model_matrix", &ModelDataRefl::model_matrix }
-			);
-		}
-	};
-
 	struct Uniform {
-		ReflectedParameter<CameraRefl>	  camera;
-		ReflectedParameter<PbrRefl>		  pbr;
-		ReflectedParameter<ModelDataRefl> model_data;
+		ReflectedParameter<CameraRefl> camera;
+		ReflectedParameter<PbrRefl>	   pbr;
 	};
 
 	template<>
 	struct ParameterRegistry<Uniform> {
 		inline static consteval auto mapping() {
 			return std::tuple {
-				std::pair {		"camera",	  &Uniform::camera },
-				std::pair {		"pbr",		   &Uniform::pbr },
-				std::pair { "model_data", &Uniform::model_data },
+				std::pair { "camera", &Uniform::camera },
+				std::pair {	"pbr",	&Uniform::pbr },
 			};
 		}
 	};
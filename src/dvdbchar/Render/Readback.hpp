@@ -0,0 +1,181 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace dvdbchar::Render {
+	/// Texture or buffer contents mapped back from the GPU, valid during the callback only.
+	struct Readback {
+		std::span<const std::byte> data;
+		uint32_t				   width		 = 0;  // texels, 0 for buffers
+		uint32_t				   height		 = 0;
+		uint32_t				   bytes_per_row = 0;  // padded to 256 for textures
+		uint64_t				   frame		 = 0;  // `submitted()` calls before the capture
+
+		/// Row `y` without the padding.
+		[[nodiscard]] auto row(uint32_t y) const -> std::span<const std::byte> {
+			return data.subspan(size_t { y } * bytes_per_row, size_t { width } * 4);
+		}
+	};
+
+	/// N-buffered GPU to CPU readback that never stalls the render thread.
+	///
+	/// `capture()` records a copy into one of `depth` `MapRead` slots on the frame's encoder and
+	/// `submitted()` maps the slots of that frame once it was submitted. The map completes a
+	/// frame or two later from `ProcessEvents()`, the callback sees the data in place, and the
+	/// slot is free again. While every slot is in flight captures are dropped, not waited for.
+	class ReadbackRing {
+	public:
+		using Callback = std::function<void(const Readback&)>;
+
+		struct Spec {
+			uint32_t depth = 3;
+		};
+
+		/// `bytesPerRow` alignment of texture to buffer copies.
+		inline static constexpr uint32_t row_alignment = 256;
+
+	public:
+		ReadbackRing(const WgpuContext& ctx, const Spec& spec = {}) : _ctx(&ctx) {
+			for (uint32_t i = 0; i < spec.depth; ++i) _slots.push_back(std::make_shared<Slot>());
+		}
+
+		ReadbackRing(const Spec& spec = {}) : ReadbackRing(WgpuContext::global(), spec) {}
+
+	public:
+		/// Copies mip 0 of `texture`, a 4-byte-per-texel format, into a free slot. Returns
+		/// false and drops the capture when all slots are in flight.
+		auto capture(
+			const wgpu::CommandEncoder& cmd, const wgpu::Texture& texture, Callback callback
+		) -> bool {
+			const auto width  = texture.GetWidth();
+			const auto height = texture.GetHeight();
+			const auto pitch  = (width * 4 + row_alignment - 1) / row_alignment * row_alignment;
+			auto*	   slot	  = _acquire(uint64_t { pitch } * height);
+			if (!slot)
+				return false;
+
+			const wgpu::TexelCopyTextureInfo src { .texture = texture };
+			const wgpu::TexelCopyBufferInfo	 dst {
+				 .layout = { .offset = 0, .bytesPerRow = pitch, .rowsPerImage = height },
+				 .buffer = slot->buffer,
+			 };
+			const wgpu::Extent3D extent { width, height, 1 };
+			cmd.CopyTextureToBuffer(&src, &dst, &extent);
+
+			slot->result = {
+				.width		   = width,
+				.height		   = height,
+				.bytes_per_row = pitch,
+				.frame		   = _frame,
+			};
+			slot->callback = std::move(callback);
+			return true;
+		}
+
+		/// Copies `size` bytes of `buffer` from `offset` on; both must be multiples of 4.
+		auto capture(
+			const wgpu::CommandEncoder& cmd, const wgpu::Buffer& buffer, uint64_t offset,
+			uint64_t size, Callback callback
+		) -> bool {
+			auto* slot = _acquire(size);
+			if (!slot)
+				return false;
+
+			cmd.CopyBufferToBuffer(buffer, offset, slot->buffer, 0, size);
+			slot->result   = { .bytes_per_row = static_cast<uint32_t>(size), .frame = _frame };
+			slot->callback = std::move(callback);
+			return true;
+		}
+
+		/// Starts mapping everything captured since the last call. Call after the submit.
+		void submitted() {
+			for (const auto& slot : _slots) {
+				if (slot->state != Slot::State::recorded)
+					continue;
+				slot->state = Slot::State::mapping;
+				slot->buffer.MapAsync(
+					wgpu::MapMode::Read,
+					0,
+					slot->used,
+					wgpu::CallbackMode::AllowProcessEvents,
+					[slot](wgpu::MapAsyncStatus status, wgpu::StringView message) {
+						if (status == wgpu::MapAsyncStatus::Success) {
+							auto result = slot->result;
+							result.data = {
+								static_cast<const std::byte*>(
+									slot->buffer.GetConstMappedRange(0, slot->used)
+								),
+								static_cast<size_t>(slot->used),
+							};
+							std::invoke(slot->callback, result);
+							slot->buffer.Unmap();
+						} else
+							spdlog::warn("readback dropped: {}", std::string_view(message));
+						slot->callback = nullptr;
+						slot->state	   = Slot::State::free;
+					}
+				);
+			}
+			++_frame;
+		}
+
+		/// Slots waiting for their copy or map to complete.
+		[[nodiscard]] auto in_flight() const -> uint32_t {
+			return static_cast<uint32_t>(std::ranges::count_if(_slots, [](const auto& slot) {
+				return slot->state != Slot::State::free;
+			}));
+		}
+
+	private:
+		struct Slot {
+			enum class State { free, recorded, mapping };
+
+			TrackedBuffer buffer;
+			uint64_t	  size	 = 0;
+			uint64_t	  used	 = 0;  // bytes copied by the current capture
+			State		  state	 = State::free;
+			Readback	  result = {};
+			Callback	  callback;
+		};
+
+		/// Free slot holding at least `size` bytes, or none.
+		[[nodiscard]] auto _acquire(uint64_t size) -> Slot* {
+			const auto it = std::ranges::find_if(_slots, [](const auto& slot) {
+				return slot->state == Slot::State::free;
+			});
+			if (it == _slots.end())
+				return nullptr;
+
+			auto& slot = **it;
+			if (slot.size < size) {
+				const wgpu::BufferDescriptor desc {
+					.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst,
+					.size  = size,
+				};
+				const MemoryTracker::Scope scope { "ReadbackRing" };
+				slot.buffer = create_buffer(*_ctx, desc);
+				slot.size	= size;
+			}
+			slot.used  = size;
+			slot.state = Slot::State::recorded;
+			return &slot;
+		}
+
+	private:
+		const WgpuContext*				   _ctx;
+		std::vector<std::shared_ptr<Slot>> _slots;	// shared with pending map callbacks
+		uint64_t						   _frame = 0;
+	};
+}  // namespace dvdbchar::Render
@@ -444,8 +444,11 @@ namespace dvdbchar::Render {
 			}
 		}  // namespace details
 
+		/// `dynamic_offset`: the block's uniform buffer is bound with a dynamic offset, as
+		/// suballocated from a `UniformRing`.
 		inline auto bindgroup_layout(
-			const WgpuContext& ctx, simdjson::ondemand::value&& parameter
+			const WgpuContext& ctx, simdjson::ondemand::value&& parameter,
+			bool dynamic_offset = false
 		) {
 			auto param = parameter.get_object();
 
@@ -459,12 +462,30 @@ namespace dvdbchar::Render {
 				if (kind == "uniform")
 					entries.emplace_back(wgpu::BindGroupLayoutEntry {
 						.binding = (uint32_t)binding["binding"],
-						.visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment,
+						.visibility = wgpu::ShaderStage::Vertex | wgpu::ShaderStage::Fragment
+									| wgpu::ShaderStage::Compute,
 						.buffer = {
 							.type = wgpu::BufferBindingType::Uniform,
+							.hasDynamicOffset = dynamic_offset,
 							.minBindingSize = binding["size"],
 						},
 					});
+				else if (kind == "storage") {
+					// Writable storage buffers are not allowed in vertex shaders.
+					std::string_view access	  = binding["access"];
+					const bool		 writable = access == "readWrite";
+					entries.emplace_back(wgpu::BindGroupLayoutEntry {
+						.binding = (uint32_t)binding["binding"],
+						.visibility = writable ? wgpu::ShaderStage::Compute
+											   : wgpu::ShaderStage::Vertex
+													 | wgpu::ShaderStage::Fragment
+													 | wgpu::ShaderStage::Compute,
+						.buffer = {
+							.type = writable ? wgpu::BufferBindingType::Storage
+											 : wgpu::BufferBindingType::ReadOnlyStorage,
+						},
+					});
+				}
 				else if (kind == "texture")
 					entries.emplace_back(wgpu::BindGroupLayoutEntry {
 						.binding = (uint32_t)binding["binding"],
@@ -497,39 +518,54 @@ namespace dvdbchar::Render {
 		}
 
 		inline auto bindgroup_layout(
-			const WgpuContext& ctx, std::string_view name, simdjson::ondemand::value&& json
+			const WgpuContext& ctx, std::string_view name, simdjson::ondemand::value&& json,
+			bool dynamic_offset = false
 		) {
-			return parsed::bindgroup_layout(ctx, json["parameters"][name]);
+			return parsed::bindgroup_layout(ctx, json["parameters"][name], dynamic_offset);
 		}
 
-		inline auto bindgroup_layouts(const WgpuContext& ctx, simdjson::ondemand::value&& json)
-			-> std::vector<wgpu::BindGroupLayout> {
+		/// `dynamic`: bind group indices whose uniform block is bound with a dynamic offset.
+		inline auto bindgroup_layouts(
+			const WgpuContext& ctx, simdjson::ondemand::value&& json,
+			std::span<const uint32_t> dynamic = {}
+		) -> std::vector<wgpu::BindGroupLayout> {
 			auto parameters = json["all"].get_array();
 
 			//
 			std::vector<wgpu::BindGroupLayout> layouts;
 			layouts.reserve(parameters.count_elements());
 
-			for (auto&& parameter : parameters)
-				layouts.emplace_back(parsed::bindgroup_layout(ctx, std::move(parameter)));
+			for (auto&& parameter : parameters) {
+				const auto group		  = static_cast<uint32_t>(layouts.size());
+				const bool dynamic_offset = std::ranges::find(dynamic, group) != dynamic.end();
+				layouts.emplace_back(
+					parsed::bindgroup_layout(ctx, std::move(parameter), dynamic_offset)
+				);
+			}
 			return layouts;
 		}
 
 		inline auto bindgroup_layout_from_path(
-			const WgpuContext& ctx, std::string_view name, const std::filesystem::path& path
+			const WgpuContext& ctx, std::string_view name, const std::filesystem::path& path,
+			bool dynamic_offset = false
 		) {
 			using namespace simdjson::ondemand;
 			using namespace simdjson;
 			parser parser;
 			auto   str	= padded_string::load(path.string());
 			auto   json = parser.iterate(str);
-			return parsed::bindgroup_layout(ctx, name, json);
+			return parsed::bindgroup_layout(ctx, name, json, dynamic_offset);
 		}
 
 		inline auto bindgroup_layout_from_path(
-			std::string_view name, const std::filesystem::path& path
+			std::string_view name, const std::filesystem::path& path, bool dynamic_offset = false
 		) {
-			return parsed::bindgroup_layout_from_path(WgpuContext::global(), name, path);
+			return parsed::bindgroup_layout_from_path(
+				WgpuContext::global(),
+				name,
+				path,
+				dynamic_offset
+			);
 		}
 
 		inline auto bindgroup_layouts_from_path(
@@ -547,13 +583,15 @@ namespace dvdbchar::Render {
 			return parsed::bindgroup_layouts_from_path(WgpuContext::global(), path);
 		}
 
-		inline auto bindgroup_layouts_from_string(const WgpuContext& ctx, std::string_view s) {
+		inline auto bindgroup_layouts_from_string(
+			const WgpuContext& ctx, std::string_view s, std::span<const uint32_t> dynamic = {}
+		) {
 			using namespace simdjson::ondemand;
 			using namespace simdjson;
 			parser parser;
 			auto   str	= padded_string { s };
 			auto   json = parser.iterate(str);
-			return parsed::bindgroup_layouts(ctx, json);
+			return parsed::bindgroup_layouts(ctx, json, dynamic);
 		}
 
 		inline auto bindgroup_layouts_from_string(std::string_view s) {
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dvdbchar::Render {
+	/// Pool of `MapWrite` staging chunks feeding copies recorded into the frame's command encoder.
+	///
+	/// Free chunks stay mapped, so `write()` is a `memcpy` plus a `CopyBufferToBuffer`. `finish()`
+	/// unmaps the chunks written this frame before the submit and `recall()` maps them again;
+	/// that map only completes once the GPU is done with the submitted work, and the chunk goes
+	/// back to the pool from its callback. A write never waits: with no chunk free a new one is
+	/// created mapped.
+	///
+	/// Writes larger than `chunk_size` get a buffer of their own, destroyed once the GPU is done
+	/// with their copy, and chunks coming back beyond `max_free` bytes of free ones are
+	/// destroyed as well, so a burst of uploads does not stay resident after loading.
+	class StagingBelt {
+	public:
+		struct Spec {
+			size_t chunk_size = 1 << 20;
+			size_t max_free	  = 16 << 20;  // bytes of free chunks kept mapped
+		};
+
+	public:
+		StagingBelt(wgpu::Device device, const Spec& spec = {}) :
+			_device(std::move(device)), _spec(spec) {}
+
+		StagingBelt(const WgpuContext& ctx, const Spec& spec = {}) :
+			StagingBelt(ctx.device, spec) {}
+
+		StagingBelt(const Spec& spec = {}) : StagingBelt(WgpuContext::global(), spec) {}
+
+	public:
+		/// Stages `data` and records its copy to `dst` at `offset` into `cmd`, outside of any
+		/// pass. As with `WriteBuffer`, offset and size must be multiples of 4.
+		void write(
+			const wgpu::CommandEncoder& cmd, const wgpu::Buffer& dst, uint64_t offset,
+			std::span<const std::byte> data
+		) {
+			if (data.empty())
+				return;
+			if (data.size() > _spec.chunk_size) {
+				auto& chunk = _dedicated.emplace_back(_create(_align(data.size())));
+				std::memcpy(chunk.mapped, data.data(), data.size());
+				cmd.CopyBufferToBuffer(chunk.buffer, 0, dst, offset, data.size());
+				return;
+			}
+			auto& chunk = _chunk_for(data.size());
+			std::memcpy(chunk.mapped + chunk.used, data.data(), data.size());
+			cmd.CopyBufferToBuffer(chunk.buffer, chunk.used, dst, offset, data.size());
+			chunk.used += _align(data.size());
+		}
+
+		/// Unmaps the chunks written this frame. Call before submitting the encoder.
+		void finish() {
+			for (auto& chunk : _active) chunk.buffer.Unmap();
+			std::ranges::move(_active, std::back_inserter(_closed));
+			_active.clear();
+			for (auto& chunk : _dedicated) chunk.buffer.Unmap();
+			std::ranges::move(_dedicated, std::back_inserter(_retiring));
+			_dedicated.clear();
+		}
+
+		/// Returns the chunks of everything submitted so far to the pool as the GPU retires them,
+		/// and destroys the buffers of oversized writes then. Call after the submit.
+		void recall() {
+			for (const auto& chunk : _closed)
+				chunk.buffer.MapAsync(
+					wgpu::MapMode::Write,
+					0,
+					chunk.size,
+					wgpu::CallbackMode::AllowProcessEvents,
+					[free = _free, chunk, max_free = _spec.max_free](
+						wgpu::MapAsyncStatus status, wgpu::StringView
+					) {
+						if (status != wgpu::MapAsyncStatus::Success)
+							return;	 // device lost or belt destroyed, the chunk goes with it
+						if (free->bytes + chunk.size > max_free) {
+							chunk.buffer.Destroy();
+							return;
+						}
+						auto ready	 = chunk;
+						ready.mapped = static_cast<std::byte*>(
+							ready.buffer.GetMappedRange(0, ready.size)
+						);
+						ready.used	 = 0;
+						free->bytes += ready.size;
+						free->chunks.push_back(std::move(ready));
+					}
+				);
+			_closed.clear();
+
+			if (_retiring.empty())
+				return;
+			_device.GetQueue().OnSubmittedWorkDone(
+				wgpu::CallbackMode::AllowProcessEvents,
+				[retired = std::exchange(_retiring, {})](
+					wgpu::QueueWorkDoneStatus, wgpu::StringView
+				) {
+					for (const auto& chunk : retired) chunk.buffer.Destroy();
+				}
+			);
+		}
+
+	private:
+		struct Chunk {
+			TrackedBuffer buffer;
+			size_t		  size	 = 0;
+			size_t		  used	 = 0;
+			std::byte*	  mapped = nullptr;
+		};
+
+		/// Mapped chunks ready for writes. Map callbacks may outlive the belt, so it is shared.
+		struct FreeChunks {
+			std::vector<Chunk> chunks;
+			size_t			   bytes = 0;
+		};
+
+		[[nodiscard]] inline static constexpr auto _align(size_t size) -> size_t {
+			return (size + 3) & ~size_t { 3 };
+		}
+
+		[[nodiscard]] auto _chunk_for(size_t size) -> Chunk& {
+			if (!_active.empty() && _active.back().used + size <= _active.back().size)
+				return _active.back();
+
+			// The smallest free chunk that fits, so small writes leave the large ones alone.
+			auto& free = *_free;
+			auto  best = free.chunks.end();
+			for (auto it = free.chunks.begin(); it != free.chunks.end(); ++it)
+				if (it->size >= size && (best == free.chunks.end() || it->size < best->size))
+					best = it;
+			if (best != free.chunks.end()) {
+				free.bytes -= best->size;
+				_active.push_back(std::move(*best));
+				free.chunks.erase(best);
+			} else
+				_active.push_back(_create(_spec.chunk_size));
+			return _active.back();
+		}
+
+		[[nodiscard]] auto _create(size_t size) const -> Chunk {
+			const wgpu::BufferDescriptor desc {
+				.usage			  = wgpu::BufferUsage::MapWrite | wgpu::BufferUsage::CopySrc,
+				.size			  = size,
+				.mappedAtCreation = true,
+			};
+			const MemoryTracker::Scope scope { "StagingBelt" };
+
+			auto buffer = create_buffer(_device, desc);
+			auto mapped = static_cast<std::byte*>(buffer.GetMappedRange(0, size));
+			return { .buffer = std::move(buffer), .size = size, .mapped = mapped };
+		}
+
+	private:
+		wgpu::Device						_device;
+		Spec								_spec;
+		std::vector<Chunk>					_active;	 // mapped, written this frame
+		std::vector<Chunk>					_closed;	 // unmapped, submitted or about to be
+		std::vector<Chunk>					_dedicated;	 // oversized writes of this frame
+		std::vector<Chunk>					_retiring;	 // unmapped oversized writes, submitted
+		std::shared_ptr<FreeChunks>			_free = std::make_shared<FreeChunks>();
+	};
+}  // namespace dvdbchar::Render
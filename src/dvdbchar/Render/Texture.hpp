@@ -2,9 +2,12 @@
 
 #include "dvdbchar/Render/Primitives.hpp"
 #include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+#include "dvdbchar/Render/TextureCompression.hpp"
 #include "dvdbchar/Render/Window.hpp"
 
 #include <webgpu/webgpu_cpp.h>
+#include <range/v3/all.hpp>
 
 namespace dvdbchar::Render {
 	struct TextureWrite {
@@ -14,49 +17,117 @@ namespace dvdbchar::Render {
 	};
 
 	struct ImageInfo {
-		std::span<char> data;
-		uint32_t		width;
-		uint32_t		height;
+		std::span<const char> data;
+		uint32_t			  width;
+		uint32_t			  height;
+		wgpu::TextureFormat	  format = wgpu::TextureFormat::RGBA8Unorm;	 // or `BC7RGBAUnorm`
 	};
 
-	inline auto texture_from_image(const WgpuContext& ctx, const ImageInfo& image)
-		-> wgpu::Texture {
+	namespace details::texture {
+		/// Source layout and copy extent of `image`. Compressed levels are copied in whole
+		/// 4x4 blocks, also below 4x4.
+		inline auto copy_layout(const ImageInfo& image)
+			-> std::pair<wgpu::TexelCopyBufferLayout, wgpu::Extent3D> {
+			if (image.format != wgpu::TextureFormat::BC7RGBAUnorm)
+				return {
+					{ .offset = 0, .bytesPerRow = image.width * 4, .rowsPerImage = image.height },
+					{ image.width, image.height, 1 },
+				};
+			const auto blocks_x = (image.width + 3) / 4, blocks_y = (image.height + 3) / 4;
+			return {
+				{ .offset = 0, .bytesPerRow = blocks_x * 16, .rowsPerImage = blocks_y },
+				{ blocks_x * 4, blocks_y * 4, 1 },
+			};
+		}
+	}  // namespace details::texture
+
+	/// Creates a texture whose mip level `i` is `levels[i]`. BC7 levels are uploaded as is
+	/// when the device has BC support and expanded to RGBA8 on the CPU otherwise.
+	inline auto texture_from_mips(const WgpuContext& ctx, std::span<const ImageInfo> levels)
+		-> TrackedTexture {
+		if (levels[0].format == wgpu::TextureFormat::BC7RGBAUnorm
+			&& !ctx.device.HasFeature(wgpu::FeatureName::TextureCompressionBC)) [[unlikely]] {
+			std::vector<std::vector<char>> pixels;
+			std::vector<ImageInfo>		   expanded;
+			for (const auto& level : levels) {
+				pixels.push_back(decompress_bc7(level.data, level.width, level.height));
+				expanded.push_back({
+					.data	= pixels.back(),
+					.width	= level.width,
+					.height = level.height,
+				});
+			}
+			return texture_from_mips(ctx, expanded);
+		}
+
 		const wgpu::TextureDescriptor desc {
 			.usage		   = wgpu::TextureUsage::TextureBinding | wgpu::TextureUsage::CopyDst,
 			.dimension	   = wgpu::TextureDimension::e2D,
-			.size		   = { image.width, image.height, 1 },
-			.format		   = wgpu::TextureFormat::RGBA8Unorm,
-			.mipLevelCount = 1,
+			.size		   = { levels[0].width, levels[0].height, 1 },
+			.format		   = levels[0].format,
+			.mipLevelCount = static_cast<uint32_t>(levels.size()),
 			.sampleCount   = 1,
 		};
-		wgpu::Texture					 texture = ctx.device.CreateTexture(&desc);
-
-		const wgpu::TexelCopyTextureInfo dest {
-			.texture  = texture,
-			.mipLevel = 0,
-			.aspect	  = wgpu::TextureAspect::All,
-		};
-		const wgpu::TexelCopyBufferLayout layout {
-			.offset		  = 0,
-			.bytesPerRow  = image.width * 4,
-			.rowsPerImage = image.height,
-		};
-		ctx.queue.WriteTexture(
-			&dest,
-			image.data.data(),
-			image.width * image.height * 4,
-			&layout,
-			&desc.size
-		);
+		auto texture = create_texture(ctx, desc);
+
+		for (const auto& [level, image] : ranges::views::enumerate(levels)) {
+			const wgpu::TexelCopyTextureInfo dest {
+				.texture  = texture,
+				.mipLevel = static_cast<uint32_t>(level),
+				.aspect	  = wgpu::TextureAspect::All,
+			};
+			const auto [layout, size] = details::texture::copy_layout(image);
+			ctx.queue.WriteTexture(&dest, image.data.data(), image.data.size(), &layout, &size);
+		}
 
 		return texture;
 	}
 
-	inline auto texture_from_image(const ImageInfo& image) -> wgpu::Texture {
+	inline auto texture_from_image(const WgpuContext& ctx, const ImageInfo& image)
+		-> TrackedTexture {
+		return texture_from_mips(ctx, std::span { &image, 1 });
+	}
+
+	inline auto texture_from_image(const ImageInfo& image) -> TrackedTexture {
 		return texture_from_image(WgpuContext::global(), image);
 	}
 
-	inline auto depth_texture(const WgpuContext& ctx, const Size& size) -> wgpu::Texture {
+	inline auto texture_from_mips(std::span<const ImageInfo> levels) -> TrackedTexture {
+		return texture_from_mips(WgpuContext::global(), levels);
+	}
+
+	/// Creates and fills one texture per image. All `WriteTexture`s are queued back to back and
+	/// land in the same queue submission.
+	inline auto textures_from_images(const WgpuContext& ctx, std::span<const ImageInfo> images)
+		-> std::vector<TrackedTexture> {
+		std::vector<TrackedTexture> textures;
+		textures.reserve(images.size());
+		for (const auto& image : images) textures.emplace_back(texture_from_image(ctx, image));
+		return textures;
+	}
+
+	inline auto textures_from_images(std::span<const ImageInfo> images)
+		-> std::vector<TrackedTexture> {
+		return textures_from_images(WgpuContext::global(), images);
+	}
+
+	inline auto solid_texture(const WgpuContext& ctx, std::array<uint8_t, 4> rgba)
+		-> TrackedTexture {
+		return texture_from_image(
+			ctx,
+			ImageInfo {
+				.data	= { reinterpret_cast<char*>(rgba.data()), rgba.size() },
+				.width	= 1,
+				.height = 1,
+			}
+		);
+	}
+
+	inline auto solid_texture(std::array<uint8_t, 4> rgba) -> TrackedTexture {
+		return solid_texture(WgpuContext::global(), rgba);
+	}
+
+	inline auto depth_texture(const WgpuContext& ctx, const Size& size) -> TrackedTexture {
 		const wgpu::TextureFormat	  format = wgpu::TextureFormat::Depth24Plus;
 		const wgpu::TextureDescriptor desc {
 			.usage	   = wgpu::TextureUsage::RenderAttachment,
@@ -66,10 +137,10 @@ namespace dvdbchar::Render {
 			.viewFormatCount = 1,
 			.viewFormats	 = &format,
 		};
-		return ctx.device.CreateTexture(&desc);
+		return create_texture(ctx, desc);
 	}
 
-	inline auto depth_texture(const Size& size) -> wgpu::Texture {
+	inline auto depth_texture(const Size& size) -> TrackedTexture {
 		return depth_texture(WgpuContext::global(), size);
 	}
 
@@ -106,6 +177,24 @@ namespace dvdbchar::Render {
 		return isotropic_sampler(WgpuContext::global(), address_mode, filter);
 	}
 
+	/// Linear filtering within and between mip levels.
+	inline auto trilinear_sampler(const WgpuContext& ctx, wgpu::AddressMode address_mode)
+		-> wgpu::Sampler {
+		const wgpu::SamplerDescriptor desc {
+			.addressModeU = address_mode,
+			.addressModeV = address_mode,
+			.addressModeW = address_mode,
+			.magFilter	  = wgpu::FilterMode::Linear,
+			.minFilter	  = wgpu::FilterMode::Linear,
+			.mipmapFilter = wgpu::MipmapFilterMode::Linear,
+		};
+		return ctx.device.CreateSampler(&desc);
+	}
+
+	inline auto trilinear_sampler(wgpu::AddressMode address_mode) -> wgpu::Sampler {
+		return trilinear_sampler(WgpuContext::global(), address_mode);
+	}
+
 	class ScreenwiseTextureManager {
 	public:
 		// TODO:
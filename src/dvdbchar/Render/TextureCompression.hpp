@@ -0,0 +1,297 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace dvdbchar::Render {
+	namespace details::texture_compression {
+		/// Interpolation weights of 4-bit BC7 indices, out of 64.
+		inline constexpr std::array<uint32_t, 16> weights4 = {
+			0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64,
+		};
+
+		using Block	 = std::array<std::byte, 16>;
+		using Texels = std::array<glm::vec4, 16>;
+
+		/// Little endian bit stream over one 128-bit block.
+		class BlockBits {
+		public:
+			BlockBits() = default;
+
+			explicit BlockBits(std::span<const std::byte, 16> block) {
+				std::ranges::copy(block, _bytes.begin());
+			}
+
+		public:
+			void write(uint32_t value, uint32_t bits) {
+				for (uint32_t i = 0; i < bits; ++i, ++_pos)
+					if (value >> i & 1)
+						_bytes[_pos / 8] |= std::byte { static_cast<uint8_t>(1u << _pos % 8) };
+			}
+
+			[[nodiscard]] auto read(uint32_t bits) -> uint32_t {
+				uint32_t value = 0;
+				for (uint32_t i = 0; i < bits; ++i, ++_pos)
+					value |= (std::to_integer<uint32_t>(_bytes[_pos / 8]) >> _pos % 8 & 1u) << i;
+				return value;
+			}
+
+			[[nodiscard]] auto bytes() const -> const Block& { return _bytes; }
+
+		private:
+			Block	 _bytes = {};
+			uint32_t _pos	= 0;
+		};
+
+		/// A 7-bit endpoint plus its p-bit, expanded to 8 bits per channel.
+		struct Endpoint {
+			glm::uvec4 quantized;
+			uint32_t   pbit;
+
+			[[nodiscard]] auto expanded() const -> glm::uvec4 { return quantized * 2u + pbit; }
+		};
+
+		/// Closest mode 6 endpoint to `color`, trying both p-bits.
+		inline auto quantize(const glm::vec4& color) -> Endpoint {
+			Endpoint best;
+			float	 best_error = std::numeric_limits<float>::max();
+			for (uint32_t pbit = 0; pbit < 2; ++pbit) {
+				const auto q = glm::uvec4 { glm::clamp(
+					glm::round((color - float(pbit)) * .5f),
+					glm::vec4 { 0.f },
+					glm::vec4 { 127.f }
+				) };
+				const auto d	 = glm::vec4 { q * 2u + pbit } - color;
+				const auto error = glm::dot(d, d);
+				if (error < best_error) {
+					best	   = { q, pbit };
+					best_error = error;
+				}
+			}
+			return best;
+		}
+
+		[[nodiscard]] inline auto interpolate(
+			const glm::uvec4& e0, const glm::uvec4& e1, uint32_t index
+		) -> glm::uvec4 {
+			const auto w = weights4[index];
+			return ((64u - w) * e0 + w * e1 + 32u) >> 6u;
+		}
+
+		/// Picks the closest palette entry for every texel; returns the total squared error.
+		inline auto assign_indices(
+			const Texels& texels, const Endpoint& e0, const Endpoint& e1,
+			std::array<uint32_t, 16>& indices
+		) -> float {
+			std::array<glm::vec4, 16> palette;
+			for (uint32_t i = 0; i < 16; ++i)
+				palette[i] = glm::vec4 { interpolate(e0.expanded(), e1.expanded(), i) };
+
+			float total = 0.f;
+			for (size_t t = 0; t < 16; ++t) {
+				float best = std::numeric_limits<float>::max();
+				for (uint32_t i = 0; i < 16; ++i) {
+					const auto d	 = palette[i] - texels[t];
+					const auto error = glm::dot(d, d);
+					if (error < best) {
+						best	   = error;
+						indices[t] = i;
+					}
+				}
+				total += best;
+			}
+			return total;
+		}
+
+		/// Principal axis of the texels through their mean, by power iteration. It starts from
+		/// the channel with the largest extent, which the principal axis cannot be orthogonal to.
+		/// Falls back to the diagonal of the bounding box if the iteration still vanishes. Zero
+		/// only for flat blocks.
+		inline auto principal_axis(const Texels& texels, const glm::vec4& mean) -> glm::vec4 {
+			glm::mat4 covariance { 0.f };
+			glm::vec4 lo = texels[0], hi = texels[0];
+			for (const auto& texel : texels) {
+				const auto d  = texel - mean;
+				covariance	 += glm::outerProduct(d, d);
+				lo			  = glm::min(lo, texel);
+				hi			  = glm::max(hi, texel);
+			}
+
+			const auto extent = hi - lo;
+			const auto size	  = glm::length(extent);
+			if (size < 1e-6f)
+				return glm::vec4 { 0.f };
+
+			glm::vec4 axis { 0.f };
+			int		  widest = 0;
+			for (int c = 1; c < 4; ++c)
+				if (extent[c] > extent[widest])
+					widest = c;
+			axis[widest] = 1.f;
+			for (int i = 0; i < 8; ++i) {
+				const auto next	  = covariance * axis;
+				const auto length = glm::length(next);
+				if (length < 1e-6f)
+					return extent / size;
+				axis = next / length;
+			}
+			return axis;
+		}
+
+		/// Endpoints minimizing the squared error for fixed `indices`, or none if degenerate.
+		inline auto fit_endpoints(
+			const Texels& texels, const std::array<uint32_t, 16>& indices, glm::vec4& e0,
+			glm::vec4& e1
+		) -> bool {
+			float	  a = 0.f, b = 0.f, c = 0.f;
+			glm::vec4 r0 { 0.f }, r1 { 0.f };
+			for (size_t t = 0; t < 16; ++t) {
+				const float w  = weights4[indices[t]] / 64.f;
+				a			  += (1.f - w) * (1.f - w);
+				b			  += (1.f - w) * w;
+				c			  += w * w;
+				r0			  += (1.f - w) * texels[t];
+				r1			  += w * texels[t];
+			}
+			const float det = a * c - b * b;
+			if (std::abs(det) < 1e-6f)
+				return false;
+			e0 = glm::clamp((c * r0 - b * r1) / det, glm::vec4 { 0.f }, glm::vec4 { 255.f });
+			e1 = glm::clamp((a * r1 - b * r0) / det, glm::vec4 { 0.f }, glm::vec4 { 255.f });
+			return true;
+		}
+
+		/// Mode 6 block: one RGBA subset, 7-bit endpoints with p-bits and 4-bit indices. Plenty
+		/// for albedo maps and the only mode `decode_block` has to understand.
+		inline auto encode_block(const Texels& texels) -> Block {
+			glm::vec4 mean { 0.f };
+			for (const auto& texel : texels) mean += texel;
+			mean /= 16.f;
+
+			const auto axis = principal_axis(texels, mean);
+			float	   lo = 0.f, hi = 0.f;
+			for (const auto& texel : texels) {
+				const float t = glm::dot(texel - mean, axis);
+				lo			  = std::min(lo, t);
+				hi			  = std::max(hi, t);
+			}
+
+			const auto clamp = [](const glm::vec4& v) {
+				return glm::clamp(v, glm::vec4 { 0.f }, glm::vec4 { 255.f });
+			};
+			auto					 e0	   = quantize(clamp(mean + axis * lo));
+			auto					 e1	   = quantize(clamp(mean + axis * hi));
+			std::array<uint32_t, 16> indices;
+			auto					 error = assign_indices(texels, e0, e1, indices);
+
+			// One least squares refinement of the endpoints, kept if it helps.
+			if (glm::vec4 f0, f1; error > 0.f && fit_endpoints(texels, indices, f0, f1)) {
+				const auto				 r0 = quantize(f0), r1 = quantize(f1);
+				std::array<uint32_t, 16> refined;
+				if (const auto refined_error = assign_indices(texels, r0, r1, refined);
+					refined_error < error) {
+					e0		= r0;
+					e1		= r1;
+					indices = refined;
+				}
+			}
+
+			// The first index drops its top bit, so it has to be in the lower half.
+			if (indices[0] >= 8) {
+				std::swap(e0, e1);
+				for (auto& index : indices) index = 15 - index;
+			}
+
+			BlockBits bits;
+			bits.write(1u << 6, 7);
+			for (int c = 0; c < 4; ++c) {
+				bits.write(e0.quantized[c], 7);
+				bits.write(e1.quantized[c], 7);
+			}
+			bits.write(e0.pbit, 1);
+			bits.write(e1.pbit, 1);
+			bits.write(indices[0], 3);
+			for (size_t t = 1; t < 16; ++t) bits.write(indices[t], 4);
+			return bits.bytes();
+		}
+
+		/// Decodes a block written by `encode_block`. Other modes come out transparent black.
+		inline void decode_block(std::span<const std::byte, 16> block, std::span<uint8_t, 64> out) {
+			BlockBits bits { block };
+			if (bits.read(7) != 1u << 6) [[unlikely]] {
+				std::ranges::fill(out, uint8_t { 0 });
+				return;
+			}
+
+			glm::uvec4 q0, q1;
+			for (int c = 0; c < 4; ++c) {
+				q0[c] = bits.read(7);
+				q1[c] = bits.read(7);
+			}
+			const auto e0 = q0 * 2u + bits.read(1);
+			const auto e1 = q1 * 2u + bits.read(1);
+			for (size_t t = 0; t < 16; ++t) {
+				const auto color = interpolate(e0, e1, bits.read(t == 0 ? 3 : 4));
+				for (int c = 0; c < 4; ++c) out[t * 4 + c] = static_cast<uint8_t>(color[c]);
+			}
+		}
+	}  // namespace details::texture_compression
+
+	[[nodiscard]] inline constexpr auto bc7_size(uint32_t width, uint32_t height) -> size_t {
+		return size_t { (width + 3) / 4 } * ((height + 3) / 4) * 16;
+	}
+
+	/// Compresses tightly packed RGBA8 `pixels` to BC7 blocks in row order. Edge blocks of
+	/// images not a multiple of 4 repeat the last row and column.
+	inline void compress_bc7(
+		std::span<const std::byte> pixels, uint32_t width, uint32_t height, std::span<std::byte> out
+	) {
+		using namespace details::texture_compression;
+
+		const auto blocks_x = (width + 3) / 4;
+		for (uint32_t by = 0; by < (height + 3) / 4; ++by)
+			for (uint32_t bx = 0; bx < blocks_x; ++bx) {
+				Texels texels;
+				for (uint32_t t = 0; t < 16; ++t) {
+					const auto	x	  = std::min(bx * 4 + t % 4, width - 1);
+					const auto	y	  = std::min(by * 4 + t / 4, height - 1);
+					const auto* texel = pixels.data() + (size_t { y } * width + x) * 4;
+					for (int c = 0; c < 4; ++c) texels[t][c] = std::to_integer<uint8_t>(texel[c]);
+				}
+				const auto block = encode_block(texels);
+				std::ranges::copy(block, out.begin() + (size_t { by } * blocks_x + bx) * 16);
+			}
+	}
+
+	/// Expands BC7 `blocks` back to tightly packed RGBA8, for adapters without BC support.
+	inline auto decompress_bc7(std::span<const char> blocks, uint32_t width, uint32_t height)
+		-> std::vector<char> {
+		using namespace details::texture_compression;
+
+		std::vector<char> pixels(size_t { width } * height * 4);
+		const auto		  blocks_x = (width + 3) / 4;
+		for (uint32_t by = 0; by < (height + 3) / 4; ++by)
+			for (uint32_t bx = 0; bx < blocks_x; ++bx) {
+				std::array<uint8_t, 64> texels;
+				decode_block(
+					std::as_bytes(blocks.subspan((size_t { by } * blocks_x + bx) * 16).first<16>()),
+					texels
+				);
+				for (uint32_t t = 0; t < 16; ++t) {
+					const auto x = bx * 4 + t % 4, y = by * 4 + t / 4;
+					if (x < width && y < height)
+						std::memcpy(&pixels[(size_t { y } * width + x) * 4], &texels[t * 4], 4);
+				}
+			}
+		return pixels;
+	}
+}  // namespace dvdbchar::Render
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace dvdbchar::Render {
+	/// Per-frame uniform data suballocated from one buffer split into `frames` slices.
+	///
+	/// Each frame bump-allocates 256-byte aligned chunks from its slice, writes them on the CPU
+	/// and uploads the whole slice with one `WriteBuffer` in `flush()`. Bind groups are created
+	/// once over `binding()` with `hasDynamicOffset` layouts, and draws pass the chunk offsets
+	/// instead of switching bind groups.
+	class UniformRing {
+	public:
+		/// WebGPU's default `minUniformBufferOffsetAlignment`.
+		inline static constexpr uint32_t alignment = 256;
+
+		struct Spec {
+			size_t	 slice_size = 1 << 20;
+			uint32_t frames		= 3;
+		};
+
+		struct Allocation {
+			uint32_t			 offset;  // dynamic offset into `buffer()`
+			std::span<std::byte> data;
+		};
+
+	public:
+		UniformRing(const WgpuContext& ctx, const Spec& spec = {}) :
+			_spec(spec), _shadow(_align(spec.slice_size)) {
+			const wgpu::BufferDescriptor desc {
+				.usage = wgpu::BufferUsage::Uniform | wgpu::BufferUsage::CopyDst,
+				.size  = _shadow.size() * spec.frames,
+			};
+			_buffer = create_buffer(ctx, desc);
+		}
+
+		UniformRing(const Spec& spec = {}) : UniformRing(WgpuContext::global(), spec) {}
+
+	public:
+		[[nodiscard]] auto buffer() const -> const wgpu::Buffer& { return _buffer; }
+
+		/// Entry binding blocks of `size` bytes; the offset comes with every `SetBindGroup`.
+		[[nodiscard]] auto binding(uint32_t binding, size_t size) const -> wgpu::BindGroupEntry {
+			return { .binding = binding, .buffer = _buffer, .offset = 0, .size = size };
+		}
+
+		/// Moves on to the next slice, whose previous contents the GPU is done with.
+		void begin_frame() {
+			_slice = (_slice + 1) % _spec.frames;
+			_used  = 0;
+		}
+
+		[[nodiscard]] auto allocate(size_t size) -> Allocation {
+			const auto aligned = _align(size);
+			if (_used + aligned > _shadow.size()) [[unlikely]]
+				throw std::runtime_error { std::format(
+					"uniform ring slice of {} bytes exhausted, {} more requested",
+					_shadow.size(),
+					size
+				) };
+			const Allocation allocation {
+				.offset = static_cast<uint32_t>(_slice * _shadow.size() + _used),
+				.data	= std::span { _shadow }.subspan(_used, size),
+			};
+			_used += aligned;
+			return allocation;
+		}
+
+		/// Copies `value` into a fresh chunk; returns its dynamic offset.
+		template<typename T>
+		[[nodiscard]] auto push(const T& value) -> uint32_t {
+			const auto allocation = allocate(sizeof(T));
+			std::memcpy(allocation.data.data(), &value, sizeof(T));
+			return allocation.offset;
+		}
+
+		/// Uploads everything allocated this frame at once.
+		void flush(const WgpuContext& ctx) {
+			if (_used > 0)
+				ctx.queue.WriteBuffer(_buffer, _slice * _shadow.size(), _shadow.data(), _used);
+		}
+
+		void flush() { flush(WgpuContext::global()); }
+
+	private:
+		[[nodiscard]] inline static constexpr auto _align(size_t size) -> size_t {
+			return (size + alignment - 1) / alignment * alignment;
+		}
+
+	private:
+		Spec				   _spec;
+		TrackedBuffer		   _buffer;
+		std::vector<std::byte> _shadow;	 // CPU side of the current slice
+		uint32_t			   _slice = 0;
+		size_t				   _used  = 0;
+	};
+}  // namespace dvdbchar::Render
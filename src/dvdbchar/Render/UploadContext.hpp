@@ -0,0 +1,97 @@
+#pragma once
+
+#include "dvdbchar/Render/Context.hpp"
+#include "dvdbchar/Render/StagingBelt.hpp"
+
+#include <webgpu/webgpu_cpp.h>
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace dvdbchar::Render {
+	/// Collects a frame's buffer uploads and copies into one command encoder, submitted as a
+	/// single command buffer ahead of the frame's own commands.
+	///
+	/// Writes are staged on a `StagingBelt`; copies are recorded in call order, so a copy reading
+	/// a buffer sees every earlier write to it.
+	class UploadContext {
+	public:
+		struct Stats {
+			uint32_t copies = 0;
+			uint64_t bytes	= 0;
+		};
+
+	public:
+		UploadContext(wgpu::Device device, const StagingBelt::Spec& spec = {}) :
+			_device(std::move(device)), _queue(_device.GetQueue()), _belt(_device, spec) {}
+
+		UploadContext(const WgpuContext& ctx, const StagingBelt::Spec& spec = {}) :
+			UploadContext(ctx.device, spec) {}
+
+		UploadContext(const StagingBelt::Spec& spec = {}) :
+			UploadContext(WgpuContext::global(), spec) {}
+
+	public:
+		/// Encoder of this frame's copies, created on first use. Record copies only; passes
+		/// belong to the frame's own encoder.
+		[[nodiscard]] auto encoder() -> const wgpu::CommandEncoder& {
+			if (!_encoder)
+				_encoder = _device.CreateCommandEncoder();
+			return _encoder;
+		}
+
+		/// Writes `data` to `dst` at `offset`; both must be multiples of 4 bytes.
+		void write(const wgpu::Buffer& dst, uint64_t offset, std::span<const std::byte> data) {
+			if (data.empty())
+				return;
+			_belt.write(encoder(), dst, offset, data);
+			_count(data.size());
+		}
+
+		void copy(
+			const wgpu::Buffer& src, uint64_t src_offset, const wgpu::Buffer& dst,
+			uint64_t dst_offset, uint64_t size
+		) {
+			if (size == 0)
+				return;
+			encoder().CopyBufferToBuffer(src, src_offset, dst, dst_offset, size);
+			_count(size);
+		}
+
+		/// Submits this frame's uploads followed by `commands` with a single `Submit`.
+		void submit(std::span<const wgpu::CommandBuffer> commands = {}) {
+			std::vector<wgpu::CommandBuffer> buffers;
+			buffers.reserve(commands.size() + 1);
+			if (_encoder)
+				buffers.push_back(std::exchange(_encoder, nullptr).Finish());
+			buffers.insert(buffers.end(), commands.begin(), commands.end());
+
+			_belt.finish();
+			if (!buffers.empty())
+				_queue.Submit(buffers.size(), buffers.data());
+			_belt.recall();
+			_last = std::exchange(_stats, {});
+		}
+
+		/// Uploads recorded since the last `submit()`.
+		[[nodiscard]] auto stats() const -> const Stats& { return _stats; }
+
+		/// Uploads of the last submitted frame.
+		[[nodiscard]] auto last_frame() const -> const Stats& { return _last; }
+
+	private:
+		void _count(uint64_t bytes) {
+			++_stats.copies;
+			_stats.bytes += bytes;
+		}
+
+	private:
+		wgpu::Device		 _device;
+		wgpu::Queue			 _queue;
+		StagingBelt			 _belt;
+		wgpu::CommandEncoder _encoder;
+		Stats				 _stats;
+		Stats				 _last;
+	};
+}  // namespace dvdbchar::Render
@@ -134,6 +134,7 @@ namespace dvdbchar::Render {
 			int				 height = 600;
 			std::string_view title;
 			bool			 transparent = false;
+			bool			 capturable	 = false;  // frames can be copied out, see `ReadbackRing`
 		};
 
 	public:
@@ -154,10 +155,15 @@ namespace dvdbchar::Render {
 			_surface.GetCapabilities(ctx.adapter, &capabilities);
 			_format = capabilities.formats[0];
 
+			auto usage = wgpu::TextureUsage::RenderAttachment;
+			if (spec.capturable)
+				usage |= wgpu::TextureUsage::CopySrc;
+
 			//
 			const wgpu::SurfaceConfiguration surface_conf = {
 				.device		 = ctx.device,
 				.format		 = _format,
+				.usage		 = usage,
 				.width		 = static_cast<uint32_t>(spec.width),
 				.height		 = static_cast<uint32_t>(spec.height),
 				.presentMode = capabilities.presentModes[0],
@@ -3,6 +3,8 @@
 #include <webgpu/webgpu_cpp.h>
 #include <spdlog/spdlog.h>
 
+#include <bit>
+#include <cstddef>
 #include <source_location>
 #include <stdexcept>
 #include <string_view>
@@ -138,6 +140,63 @@ namespace dvdbchar {
 		s ^= h(v) + 0x9e3779b9 + (s << 6) + (s >> 2);
 	}
 
+	/// XXH64 of `bytes`. Checksums baked model packs and fingerprints their vertex layout, so it
+	/// has to be stable across runs and platforms, which `std::hash` is not.
+	inline constexpr auto xxhash64(std::span<const std::byte> bytes, uint64_t seed = 0)
+		-> uint64_t {
+		constexpr uint64_t p1 = 11400714785074694791ull;
+		constexpr uint64_t p2 = 14029467366897019727ull;
+		constexpr uint64_t p3 = 1609587929392839161ull;
+		constexpr uint64_t p4 = 9650029242287828579ull;
+		constexpr uint64_t p5 = 2870177450012600261ull;
+
+		const auto		   read = [&]<typename U>(size_t at) {
+			  U value = 0;
+			  for (size_t i = 0; i < sizeof(U); ++i)
+				  value |= static_cast<U>(std::to_integer<uint8_t>(bytes[at + i])) << (i * 8);
+			  return value;
+		};
+		const auto round = [](uint64_t acc, uint64_t input) {
+			return std::rotl(acc + input * p2, 31) * p1;
+		};
+		const auto merge = [&](uint64_t acc, uint64_t value) {
+			return (acc ^ round(0, value)) * p1 + p4;
+		};
+
+		const size_t size = bytes.size();
+		size_t		 at	  = 0;
+		uint64_t	 h;
+		if (size >= 32) {
+			uint64_t v1 = seed + p1 + p2, v2 = seed + p2, v3 = seed, v4 = seed - p1;
+			for (; at + 32 <= size; at += 32) {
+				v1 = round(v1, read.template operator()<uint64_t>(at));
+				v2 = round(v2, read.template operator()<uint64_t>(at + 8));
+				v3 = round(v3, read.template operator()<uint64_t>(at + 16));
+				v4 = round(v4, read.template operator()<uint64_t>(at + 24));
+			}
+			h = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+			h = merge(merge(merge(merge(h, v1), v2), v3), v4);
+		} else
+			h = seed + p5;
+
+		h += size;
+		for (; at + 8 <= size; at += 8)
+			h = std::rotl(h ^ round(0, read.template operator()<uint64_t>(at)), 27) * p1 + p4;
+		if (at + 4 <= size) {
+			h	= std::rotl(h ^ read.template operator()<uint32_t>(at) * p1, 23) * p2 + p3;
+			at += 4;
+		}
+		for (; at < size; ++at)
+			h = std::rotl(h ^ std::to_integer<uint8_t>(bytes[at]) * p5, 11) * p1;
+
+		h ^= h >> 33;
+		h *= p2;
+		h ^= h >> 29;
+		h *= p3;
+		h ^= h >> 32;
+		return h;
+	}
+
 	template<typename T, typename BaseT>
 	struct is_mem_ptr_of : std::false_type {};
 
@@ -3,15 +3,26 @@
 #include "dvdbchar/Render/Texture.hpp"
 #include "dvdbchar/Model.hpp"
 #include "dvdbchar/Render/Pass/BasePass.hpp"
+#include "dvdbchar/Render/Pass/Skinningpass.hpp"
+#include "dvdbchar/Render/ComputePipeline.hpp"
 #include "dvdbchar/Render/ShaderReflection.hpp"
 #include "dvdbchar/Render/Window.hpp"
 #include "dvdbchar/Render/Camera.hpp"
 #include "dvdbchar/Render/Pipeline.hpp"
 #include "dvdbchar/Render/Buffer.hpp"
 #include "dvdbchar/Render/Buffer.hpp"
+#include "dvdbchar/Render/Instancing.hpp"
+#include "dvdbchar/Render/MemoryTracker.hpp"
 #include "dvdbchar/Render/Mesh.hpp"
+#include "dvdbchar/Render/UploadContext.hpp"
 
 #include <webgpu/webgpu_cpp.h>
+#include <stdexec/execution.hpp>
+#include <exec/async_scope.hpp>
+#include <exec/static_thread_pool.hpp>
+
+#include <filesystem>
+#include <optional>
 
 namespace dvdbchar {
 	namespace details::vtubing_app {
@@ -20,19 +31,34 @@ namespace dvdbchar {
 		class VtubingApp final {
 		public:
 			struct Spec {
-				Window::Spec window;
-				Model&&		 model;
+				Window::Spec		  window;
+				std::filesystem::path model;
 			};
 
+			/// Bytes of textures streamed to the GPU per frame while a model is loading.
+			inline static constexpr size_t upload_budget = 16 << 20;
+
 		public:
 			// clang-format off
 		VtubingApp(const Spec& spec) :
-			_window(spec.window), _model(std::move(spec.model)),
+			_window(spec.window),
             _ppl_base {{
                 .shader     = *read_text_from("shaders/Pipeline.wgsl"),
 		        .reflection = *read_text_from("shaders/Uniform.layout.json"),
                 .format     = _window.format(),
             }},
+            _ppl_morph {{
+                .shader     = *read_text_from("shaders/Morph.wgsl"),
+                .reflection = *read_text_from("shaders/Morph.layout.json"),
+            }},
+            _ppl_skinning {{
+                .shader     = *read_text_from("shaders/Skinning.wgsl"),
+                .reflection = *read_text_from("shaders/Skinning.layout.json"),
+            }},
+            _ppl_culling {{
+                .shader     = *read_text_from("shaders/Instancing.wgsl"),
+                .reflection = *read_text_from("shaders/Instancing.layout.json"),
+            }},
             _global_ub(get_mapping<GlobalRefl>("global", "shaders/Uniform.refl.json")),
             _global_bg {{
                 .layout  = parsed::bindgroup_layout_from_path("global", "shaders/Uniform.layout.json"),
@@ -51,10 +77,38 @@ namespace dvdbchar {
             _cam.aspect = _window.aspect();
             _camera_ub.write(_camera_ub.view_matrix, _cam.view_matrix());
 	        _camera_ub.write(_camera_ub.projection_matrix, _cam.projection_matrix());
+            load_model(spec.model);
         }
 
 			// clang-format on
 
+			~VtubingApp() { stdexec::sync_wait(_scope.on_empty()); }
+
+		public:
+			/// Starts loading `path` in the background and returns at once. The first model is
+			/// drawn while it streams in; later ones replace the current model only once fully
+			/// uploaded, so switching avatars never drops frames.
+			void load_model(const std::filesystem::path& path) {
+				_scope.spawn(
+					Model::load_async(path, _loader.get_scheduler())
+					| stdexec::then([this](Model model) {
+						  std::unique_lock lock { _mtx_incoming };
+						  _incoming = std::move(model);
+					  })
+					| stdexec::upon_error([path](std::exception_ptr err) {
+						  try {
+							  std::rethrow_exception(err);
+						  } catch (const std::exception& e) {
+							  spdlog::error(
+								  "failed to load model `{}`: {}",
+								  path.string(),
+								  e.what()
+							  );
+						  }
+					  })
+				);
+			}
+
 		public:
 			void launch() {
 				auto bind = _window.bind(
@@ -92,49 +146,90 @@ namespace dvdbchar {
 					.buf_index_count = 6,
 				};
 
-				auto							   test_mesh = _model._test_prmitive();
-
-				auto							   tex_depth = depth_texture(_window.get_size());
-
-				std::vector<Render::MeshPrimitive> gpu_primitives;
-				for (const auto& mesh : _model.asset().meshes)
-					for (const auto& prim : mesh.primitives)
-						gpu_primitives.push_back(_model.primitive(prim));
+				auto tex_depth = depth_texture(_window.get_size());
 
 				while (!glfwWindowShouldClose(_window.window())) {
 					wgpu::SurfaceTexture tex;
 					_window.surface().GetCurrentTexture(&tex);
 
+					// Uploads stay outside the lock: input only waits for the camera flush.
+					_stream_models();
 					std::unique_lock lock { _mtx_context };
+					_global_ub.flush(context);
+					_camera_ub.flush(context);
 
 					//
 					auto cmd = context.device.CreateCommandEncoder();
+					if (_model)
+						_model->update(_uploads);
+					if (_model && !_model->skinned_meshes().empty()) {
+						auto skinning =
+							Pass::SkinningPass { .buf_morph_offsets = _model->morph_offsets() }
+								.start(cmd);
+						for (const auto& target : _model->active_morph_targets())
+							skinning.execute(target, _ppl_morph);
+						for (const auto& mesh : _model->skinned_meshes())
+							skinning.execute(mesh, _ppl_skinning);
+						skinning.end();
+					}
+					if (_model)
+						_model->instances().cull(
+							_uploads,
+							cmd,
+							_ppl_culling,
+							_cam.projection_matrix() * _cam.view_matrix()
+						);
+
 					auto pass =
 						Pass::BasePass {
 							.tex_target = { tex.texture },
 							.tex_depth	= { tex_depth },
 						}
 							.start(cmd);
-					for (const auto& prim : gpu_primitives) {
+					const auto primitives = _model ? _model->primitives()
+												   : std::span<const MeshPrimitive> {};
+					for (const auto& [i, prim] : ranges::views::enumerate(primitives)) {
 						pass.execute(
 							prim,
+							_model->instances(),
+							i,
 							_ppl_base,
 							{
 								_global_bg,
 								_camera_bg,
 								prim.bg_pbr,
+								_model->scene_bindgroup(),
 							}
 						);
 					}
 
 					auto cbf = pass.end();
-					context.queue.Submit(1, &cbf);
+					_uploads.submit(std::span { &cbf, 1 });
 
 					_window.surface().Present();
 					context.instance.ProcessEvents();
 				}
 			}
 
+		private:
+			/// Render thread only. Picks up freshly loaded models and uploads a slice of them.
+			void _stream_models() {
+				if (std::unique_lock lock { _mtx_incoming }; _incoming)
+					_streaming = std::exchange(_incoming, std::nullopt);
+
+				// Nothing on screen yet: stream in place so meshes appear as they finish.
+				if (_streaming && !_model)
+					_model = std::exchange(_streaming, std::nullopt);
+
+				if (_model && !_model->loaded()) {
+					if (_model->upload_some(_uploads, upload_budget))
+						MemoryTracker::global().report();
+				} else if (_streaming && _streaming->upload_some(_uploads, upload_budget)) {
+					_model = std::exchange(_streaming, std::nullopt);
+					MemoryTracker::global().report();
+				}
+			}
+
 		private:
 			mutable std::mutex _mtx_context;
 			Window			   _window;
@@ -144,16 +239,25 @@ namespace dvdbchar {
 				.direction = { 0., 0., -2. },
 			};
 			// clang-format on
-			Pipeline _ppl_base;
+			Pipeline		_ppl_base;
+			ComputePipeline _ppl_morph;
+			ComputePipeline _ppl_skinning;
+			ComputePipeline _ppl_culling;
 
 			//
 			ReflectedUniformBuffer<GlobalRefl> _global_ub;
 			Bindgroup						   _global_bg;
 			ReflectedUniformBuffer<CameraRefl> _camera_ub;
 			Bindgroup						   _camera_bg;
+			UploadContext					   _uploads;
 
 			//
-			Model _model;
+			exec::static_thread_pool _loader { 1 };
+			exec::async_scope		 _scope;
+			std::mutex				 _mtx_incoming;
+			std::optional<Model>	 _incoming;	  // loaded, waiting for the render thread
+			std::optional<Model>	 _streaming;  // being uploaded while `_model` is drawn
+			std::optional<Model>	 _model;
 		};
 	}  // namespace details::vtubing_app
 
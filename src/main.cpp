@@ -42,16 +42,20 @@ int main4() {
 
 int main() {
 	// try {
-	auto app = VtubingApp {{
-			.window = {
-				.width	     = 1920,
-				.height	     = 1080,
-				.title	     = "你好我是DvdBr3o",
-				.transparent = true,
-			},
-			.model = Model { "public/VRM1_Constraint_Twist_Sample.vrm" },
-		}};
-	app.launch();
+	{
+		auto app = VtubingApp {{
+				.window = {
+					.width	     = 1920,
+					.height	     = 1080,
+					.title	     = "你好我是DvdBr3o",
+					.transparent = true,
+				},
+				.model = "public/VRM1_Constraint_Twist_Sample.vrm",
+			}};
+		app.launch();
+	}
+	DynamicBufferPool::trim_shared();
+	MemoryTracker::global().report_leaks();
 	// } catch (const std::exception& e) { spdlog::critical("Uncaught exception: {}", e.what()); }
 	return 0;
 }
@@ -39,6 +39,9 @@ target("dvdbchar.slang")
     add_deps("dvdbchar.slang.lib")
     add_rules("slang", {target_kind = "wgsl"})
     add_files("src/slang/Pipeline.slang")
+    add_files("src/slang/Skinning.slang")
+    add_files("src/slang/Morph.slang")
+    add_files("src/slang/Instancing.slang")
     
 target("dvdbchar")
     set_kind("binary")
@@ -92,3 +95,22 @@ target("dvdbchar")
         os.cp("public", path.join(target:installdir(), "public"))
         os.cp("src/slang", path.join(target:installdir(), "shaders"))
     end)
+
+-- Upload-path microbenchmark, on Dawn's SwiftShader adapter by default:
+--   xmake build dvdbchar.bench.upload && xmake run dvdbchar.bench.upload --out upload.json
+target("dvdbchar.bench.upload")
+    set_kind("binary")
+    set_languages("cxx20")
+    set_default(false)
+
+    add_packages("dawn")
+    add_packages("spdlog")
+    add_packages("stdexec")
+    add_packages("nlohmann_json")
+
+    add_files("bench/UploadBench.cpp")
+    add_includedirs("src")
+
+    if is_plat("windows") then
+        add_defines("NOMINMAX")
+    end
@@ -41,7 +41,14 @@ end
 
 function _descriptor_table_slots(parameter, target)
 	for _, field in pairs(parameter.type.elementVarLayout.type.fields) do
-		if field.type.kind == "resource" then
+		if field.type.kind == "resource" and field.type.baseShape == "structuredBuffer" then
+			target.bindings[field.name] = {
+				binding = target.bindings_count,
+				kind = "storage",
+				access = field.type.access or "read",
+			}
+			target.bindings_count = target.bindings_count + 1
+		elseif field.type.kind == "resource" then
 			local view_dimension
 			if field.type.baseShape == "texture1D" then
 				view_dimension = "e1D"